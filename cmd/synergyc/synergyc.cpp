@@ -14,6 +14,7 @@
 
 #include "CClient.h"
 #include "CScreen.h"
+#include "CThreadScheduling.h"
 #include "ProtocolTypes.h"
 #include "Version.h"
 #include "XScreen.h"
@@ -90,6 +91,7 @@ public:
 	const char*			m_display;
 	CString 			m_name;
 	CNetworkAddress* 	m_serverAddress;
+	CThreadScheduling	m_scheduling;
 };
 
 CArgs*					CArgs::s_instance = NULL;
@@ -374,6 +376,10 @@ static
 int
 mainLoop()
 {
+	// set scheduling of input handling threads.  threads we create
+	// later, like the socket multiplexer's, inherit it.
+	ARG->m_scheduling.apply();
+
 	// create socket multiplexer.  this must happen after daemonization
 	// on unix because threads evaporate across a fork().
 	CSocketMultiplexer multiplexer;
@@ -518,6 +524,9 @@ help()
 USAGE_DISPLAY_ARG
 " [--name <screen-name>]"
 " [--restart|--no-restart]"
+" [--scheduling <policy>[:<priority>]]"
+" [--cpu-affinity <cpus>]"
+" [--lock-memory]"
 " <server-address>"
 "\n\n"
 "Start the synergy mouse/keyboard sharing server.\n"
@@ -533,6 +542,14 @@ USAGE_DISPLAY_INFO
 "  -1, --no-restart         do not try to restart the client if it fails for\n"
 "                           some reason.\n"
 "*     --restart            restart the client automatically if it fails.\n"
+"      --scheduling <policy>[:<priority>]\n"
+"                           schedule the input handling threads using policy\n"
+"                           normal, rr or fifo.  for normal the priority is a\n"
+"                           nice value (default -10), otherwise a real-time\n"
+"                           priority (default 10).  usually needs privileges.\n"
+"      --cpu-affinity <cpus>\n"
+"                           run only on the listed CPUs, e.g. 0,2-3.\n"
+"      --lock-memory        lock memory to avoid paging delays.\n"
 "  -h, --help               display this help and exit.\n"
 "      --version            display version information and exit.\n"
 "\n"
@@ -628,6 +645,29 @@ parse(int argc, const char* const* argv)
 			ARG->m_restartable = true;
 		}
 
+		else if (isArg(i, argc, argv, NULL, "--scheduling", 1)) {
+			// scheduling policy for input handling threads
+			if (!ARG->m_scheduling.parsePolicy(argv[++i])) {
+				LOG((CLOG_PRINT "%s: invalid scheduling `%s'" BYE,
+								ARG->m_pname, argv[i], ARG->m_pname));
+				bye(kExitArgs);
+			}
+		}
+
+		else if (isArg(i, argc, argv, NULL, "--cpu-affinity", 1)) {
+			// CPUs to run on
+			if (!ARG->m_scheduling.parseCPUList(argv[++i])) {
+				LOG((CLOG_PRINT "%s: invalid CPU list `%s'" BYE,
+								ARG->m_pname, argv[i], ARG->m_pname));
+				bye(kExitArgs);
+			}
+		}
+
+		else if (isArg(i, argc, argv, NULL, "--lock-memory")) {
+			// avoid paging
+			ARG->m_scheduling.setLockMemory(true);
+		}
+
 		else if (isArg(i, argc, argv, "-z", NULL)) {
 			ARG->m_backend = true;
 		}
@@ -18,6 +18,7 @@
 #include "CPrimaryClient.h"
 #include "CServer.h"
 #include "CScreen.h"
+#include "CThreadScheduling.h"
 #include "ProtocolTypes.h"
 #include "Version.h"
 #include "XScreen.h"
@@ -107,6 +108,7 @@ public:
 	CString 			m_name;
 	CNetworkAddress*	m_synergyAddress;
 	CConfig*			m_config;
+	CThreadScheduling	m_scheduling;
 };
 
 CArgs*					CArgs::s_instance = NULL;
@@ -594,7 +596,7 @@ handleResume(const CEvent&, void*)
 
 static
 void
-reloadSignalHandler(CArch::ESignal, void*)
+reloadSignalHandler(IArchMultithread::ESignal, void*)
 {
 	EVENTQUEUE->addEvent(CEvent(getReloadConfigEvent(),
 							IEventQueue::getSystemTarget()));
@@ -626,6 +628,10 @@ static
 int
 mainLoop()
 {
+	// set scheduling of input handling threads.  threads we create
+	// later, like the socket multiplexer's, inherit it.
+	ARG->m_scheduling.apply();
+
 	// create socket multiplexer.  this must happen after daemonization
 	// on unix because threads evaporate across a fork().
 	CSocketMultiplexer multiplexer;
@@ -664,7 +670,7 @@ mainLoop()
 	}
 
 	// handle hangup signal by reloading the server's configuration
-	ARCH->setSignalHandler(CArch::kHANGUP, &reloadSignalHandler, NULL);
+	ARCH->setSignalHandler(IArchMultithread::kHANGUP, &reloadSignalHandler, NULL);
 	EVENTQUEUE->adoptHandler(getReloadConfigEvent(),
 							IEventQueue::getSystemTarget(),
 							new CFunctionEventJob(&reloadConfig));
@@ -836,6 +842,9 @@ help()
 USAGE_DISPLAY_ARG
 " [--name <screen-name>]"
 " [--restart|--no-restart]"
+" [--scheduling <policy>[:<priority>]]"
+" [--cpu-affinity <cpus>]"
+" [--lock-memory]"
 PLATFORM_ARGS
 "\n\n"
 "Start the synergy mouse/keyboard sharing server.\n"
@@ -853,6 +862,14 @@ USAGE_DISPLAY_INFO
 "  -1, --no-restart         do not try to restart the server if it fails for\n"
 "                           some reason.\n"
 "*     --restart            restart the server automatically if it fails.\n"
+"      --scheduling <policy>[:<priority>]\n"
+"                           schedule the input handling threads using policy\n"
+"                           normal, rr or fifo.  for normal the priority is a\n"
+"                           nice value (default -10), otherwise a real-time\n"
+"                           priority (default 10).  usually needs privileges.\n"
+"      --cpu-affinity <cpus>\n"
+"                           run only on the listed CPUs, e.g. 0,2-3.\n"
+"      --lock-memory        lock memory to avoid paging delays.\n"
 PLATFORM_DESC
 "  -h, --help               display this help and exit.\n"
 "      --version            display version information and exit.\n"
@@ -976,6 +993,29 @@ parse(int argc, const char* const* argv)
 			ARG->m_restartable = true;
 		}
 
+		else if (isArg(i, argc, argv, NULL, "--scheduling", 1)) {
+			// scheduling policy for input handling threads
+			if (!ARG->m_scheduling.parsePolicy(argv[++i])) {
+				LOG((CLOG_PRINT "%s: invalid scheduling `%s'" BYE,
+								ARG->m_pname, argv[i], ARG->m_pname));
+				bye(kExitArgs);
+			}
+		}
+
+		else if (isArg(i, argc, argv, NULL, "--cpu-affinity", 1)) {
+			// CPUs to run on
+			if (!ARG->m_scheduling.parseCPUList(argv[++i])) {
+				LOG((CLOG_PRINT "%s: invalid CPU list `%s'" BYE,
+								ARG->m_pname, argv[i], ARG->m_pname));
+				bye(kExitArgs);
+			}
+		}
+
+		else if (isArg(i, argc, argv, NULL, "--lock-memory")) {
+			// avoid paging
+			ARG->m_scheduling.setLockMemory(true);
+		}
+
 		else if (isArg(i, argc, argv, "-z", NULL)) {
 			ARG->m_backend = true;
 		}
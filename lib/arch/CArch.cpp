@@ -101,6 +101,20 @@
 #	error unsupported platform for time
 #endif
 
+// with static binding CArch calls the implementations directly rather
+// than through their vtables
+#if ARCH_STATIC_BINDING
+#	define ARCH_MT_CALL		static_cast<ARCH_MULTITHREAD*>(m_mt)->ARCH_MULTITHREAD::
+#	define ARCH_NET_CALL	static_cast<ARCH_NETWORK*>(m_net)->ARCH_NETWORK::
+#	define ARCH_STRING_CALL	static_cast<ARCH_STRING*>(m_string)->ARCH_STRING::
+#	define ARCH_TIME_CALL	static_cast<ARCH_TIME*>(m_time)->ARCH_TIME::
+#else
+#	define ARCH_MT_CALL		m_mt->
+#	define ARCH_NET_CALL	m_net->
+#	define ARCH_STRING_CALL	m_string->
+#	define ARCH_TIME_CALL	m_time->
+#endif
+
 //
 // CArch
 //
@@ -275,307 +289,358 @@ CArch::writeLog(ELevel level, const char* msg)
 CArchCond
 CArch::newCondVar()
 {
-	return m_mt->newCondVar();
+	return ARCH_MT_CALL newCondVar();
 }
 
 void
 CArch::closeCondVar(CArchCond cond)
 {
-	m_mt->closeCondVar(cond);
+	ARCH_MT_CALL closeCondVar(cond);
 }
 
 void
 CArch::signalCondVar(CArchCond cond)
 {
-	m_mt->signalCondVar(cond);
+	ARCH_MT_CALL signalCondVar(cond);
 }
 
 void
 CArch::broadcastCondVar(CArchCond cond)
 {
-	m_mt->broadcastCondVar(cond);
+	ARCH_MT_CALL broadcastCondVar(cond);
 }
 
 bool
 CArch::waitCondVar(CArchCond cond, CArchMutex mutex, double timeout)
 {
-	return m_mt->waitCondVar(cond, mutex, timeout);
+	return ARCH_MT_CALL waitCondVar(cond, mutex, timeout);
 }
 
 CArchMutex
 CArch::newMutex()
 {
-	return m_mt->newMutex();
+	return ARCH_MT_CALL newMutex();
 }
 
 void
 CArch::closeMutex(CArchMutex mutex)
 {
-	m_mt->closeMutex(mutex);
+	ARCH_MT_CALL closeMutex(mutex);
 }
 
 void
 CArch::lockMutex(CArchMutex mutex)
 {
-	m_mt->lockMutex(mutex);
+	ARCH_MT_CALL lockMutex(mutex);
 }
 
 void
 CArch::unlockMutex(CArchMutex mutex)
 {
-	m_mt->unlockMutex(mutex);
+	ARCH_MT_CALL unlockMutex(mutex);
 }
 
 CArchThread
 CArch::newThread(ThreadFunc func, void* data)
 {
-	return m_mt->newThread(func, data);
+	return ARCH_MT_CALL newThread(func, data);
 }
 
 CArchThread
 CArch::newCurrentThread()
 {
-	return m_mt->newCurrentThread();
+	return ARCH_MT_CALL newCurrentThread();
 }
 
 CArchThread
 CArch::copyThread(CArchThread thread)
 {
-	return m_mt->copyThread(thread);
+	return ARCH_MT_CALL copyThread(thread);
 }
 
 void
 CArch::closeThread(CArchThread thread)
 {
-	m_mt->closeThread(thread);
+	ARCH_MT_CALL closeThread(thread);
 }
 
 void
 CArch::cancelThread(CArchThread thread)
 {
-	m_mt->cancelThread(thread);
+	ARCH_MT_CALL cancelThread(thread);
 }
 
 void
 CArch::setPriorityOfThread(CArchThread thread, int n)
 {
-	m_mt->setPriorityOfThread(thread, n);
+	ARCH_MT_CALL setPriorityOfThread(thread, n);
+}
+
+bool
+CArch::setSchedulingOfThread(CArchThread thread,
+				ESchedulingPolicy policy, int priority)
+{
+	return ARCH_MT_CALL setSchedulingOfThread(thread, policy, priority);
+}
+
+bool
+CArch::setAffinityOfThread(CArchThread thread, const std::vector<int>& cpus)
+{
+	return ARCH_MT_CALL setAffinityOfThread(thread, cpus);
 }
 
 void
 CArch::testCancelThread()
 {
-	m_mt->testCancelThread();
+	ARCH_MT_CALL testCancelThread();
 }
 
 bool
 CArch::wait(CArchThread thread, double timeout)
 {
-	return m_mt->wait(thread, timeout);
+	return ARCH_MT_CALL wait(thread, timeout);
 }
 
 bool
 CArch::isSameThread(CArchThread thread1, CArchThread thread2)
 {
-	return m_mt->isSameThread(thread1, thread2);
+	return ARCH_MT_CALL isSameThread(thread1, thread2);
 }
 
 bool
 CArch::isExitedThread(CArchThread thread)
 {
-	return m_mt->isExitedThread(thread);
+	return ARCH_MT_CALL isExitedThread(thread);
 }
 
 void*
 CArch::getResultOfThread(CArchThread thread)
 {
-	return m_mt->getResultOfThread(thread);
+	return ARCH_MT_CALL getResultOfThread(thread);
 }
 
 IArchMultithread::ThreadID
 CArch::getIDOfThread(CArchThread thread)
 {
-	return m_mt->getIDOfThread(thread);
+	return ARCH_MT_CALL getIDOfThread(thread);
+}
+
+IArchMultithread::ThreadID
+CArch::getIDOfCurrentThread()
+{
+	return ARCH_MT_CALL getIDOfCurrentThread();
 }
 
 void
 CArch::setSignalHandler(ESignal signal, SignalFunc func, void* userData)
 {
-	m_mt->setSignalHandler(signal, func, userData);
+	ARCH_MT_CALL setSignalHandler(signal, func, userData);
 }
 
 void
 CArch::raiseSignal(ESignal signal)
 {
-	m_mt->raiseSignal(signal);
+	ARCH_MT_CALL raiseSignal(signal);
 }
 
 CArchSocket
 CArch::newSocket(EAddressFamily family, ESocketType type)
 {
-	return m_net->newSocket(family, type);
+	return ARCH_NET_CALL newSocket(family, type);
 }
 
 CArchSocket
 CArch::copySocket(CArchSocket s)
 {
-	return m_net->copySocket(s);
+	return ARCH_NET_CALL copySocket(s);
 }
 
 void
 CArch::closeSocket(CArchSocket s)
 {
-	m_net->closeSocket(s);
+	ARCH_NET_CALL closeSocket(s);
 }
 
 void
 CArch::closeSocketForRead(CArchSocket s)
 {
-	m_net->closeSocketForRead(s);
+	ARCH_NET_CALL closeSocketForRead(s);
 }
 
 void
 CArch::closeSocketForWrite(CArchSocket s)
 {
-	m_net->closeSocketForWrite(s);
+	ARCH_NET_CALL closeSocketForWrite(s);
 }
 
 void
 CArch::bindSocket(CArchSocket s, CArchNetAddress addr)
 {
-	m_net->bindSocket(s, addr);
+	ARCH_NET_CALL bindSocket(s, addr);
 }
 
 void
 CArch::listenOnSocket(CArchSocket s)
 {
-	m_net->listenOnSocket(s);
+	ARCH_NET_CALL listenOnSocket(s);
 }
 
 CArchSocket
 CArch::acceptSocket(CArchSocket s, CArchNetAddress* addr)
 {
-	return m_net->acceptSocket(s, addr);
+	return ARCH_NET_CALL acceptSocket(s, addr);
+}
+
+CArchSocket
+CArch::acceptSocket(CArchSocket s, CArchNetAddress* addr, CSocketError* error)
+{
+	return ARCH_NET_CALL acceptSocket(s, addr, error);
 }
 
 bool
 CArch::connectSocket(CArchSocket s, CArchNetAddress name)
 {
-	return m_net->connectSocket(s, name);
+	return ARCH_NET_CALL connectSocket(s, name);
 }
 
 int
 CArch::pollSocket(CPollEntry pe[], int num, double timeout)
 {
-	return m_net->pollSocket(pe, num, timeout);
+	return ARCH_NET_CALL pollSocket(pe, num, timeout);
+}
+
+int
+CArch::pollSocket(CPollEntry pe[], int num, double timeout,
+				CSocketError* error)
+{
+	return ARCH_NET_CALL pollSocket(pe, num, timeout, error);
 }
 
 void
 CArch::unblockPollSocket(CArchThread thread)
 {
-	m_net->unblockPollSocket(thread);
+	ARCH_NET_CALL unblockPollSocket(thread);
 }
 
 size_t
 CArch::readSocket(CArchSocket s, void* buf, size_t len)
 {
-	return m_net->readSocket(s, buf, len);
+	return ARCH_NET_CALL readSocket(s, buf, len);
 }
 
 size_t
 CArch::writeSocket(CArchSocket s, const void* buf, size_t len)
 {
-	return m_net->writeSocket(s, buf, len);
+	return ARCH_NET_CALL writeSocket(s, buf, len);
 }
 
 void
 CArch::throwErrorOnSocket(CArchSocket s)
 {
-	m_net->throwErrorOnSocket(s);
+	ARCH_NET_CALL throwErrorOnSocket(s);
+}
+
+size_t
+CArch::readSocket(CArchSocket s, void* buf, size_t len, CSocketError* error)
+{
+	return ARCH_NET_CALL readSocket(s, buf, len, error);
+}
+
+size_t
+CArch::writeSocket(CArchSocket s, const void* buf, size_t len,
+				CSocketError* error)
+{
+	return ARCH_NET_CALL writeSocket(s, buf, len, error);
+}
+
+bool
+CArch::getErrorOnSocket(CArchSocket s, CSocketError* error)
+{
+	return ARCH_NET_CALL getErrorOnSocket(s, error);
 }
 
 bool
 CArch::setNoDelayOnSocket(CArchSocket s, bool noDelay)
 {
-	return m_net->setNoDelayOnSocket(s, noDelay);
+	return ARCH_NET_CALL setNoDelayOnSocket(s, noDelay);
 }
 
 bool
 CArch::setReuseAddrOnSocket(CArchSocket s, bool reuse)
 {
-	return m_net->setReuseAddrOnSocket(s, reuse);
+	return ARCH_NET_CALL setReuseAddrOnSocket(s, reuse);
 }
 
 std::string
 CArch::getHostName()
 {
-	return m_net->getHostName();
+	return ARCH_NET_CALL getHostName();
 }
 
 CArchNetAddress
 CArch::newAnyAddr(EAddressFamily family)
 {
-	return m_net->newAnyAddr(family);
+	return ARCH_NET_CALL newAnyAddr(family);
 }
 
 CArchNetAddress
 CArch::copyAddr(CArchNetAddress addr)
 {
-	return m_net->copyAddr(addr);
+	return ARCH_NET_CALL copyAddr(addr);
 }
 
 CArchNetAddress
 CArch::nameToAddr(const std::string& name)
 {
-	return m_net->nameToAddr(name);
+	return ARCH_NET_CALL nameToAddr(name);
 }
 
 void
 CArch::closeAddr(CArchNetAddress addr)
 {
-	m_net->closeAddr(addr);
+	ARCH_NET_CALL closeAddr(addr);
 }
 
 std::string
 CArch::addrToName(CArchNetAddress addr)
 {
-	return m_net->addrToName(addr);
+	return ARCH_NET_CALL addrToName(addr);
 }
 
 std::string
 CArch::addrToString(CArchNetAddress addr)
 {
-	return m_net->addrToString(addr);
+	return ARCH_NET_CALL addrToString(addr);
 }
 
 IArchNetwork::EAddressFamily
 CArch::getAddrFamily(CArchNetAddress addr)
 {
-	return m_net->getAddrFamily(addr);
+	return ARCH_NET_CALL getAddrFamily(addr);
 }
 
 void
 CArch::setAddrPort(CArchNetAddress addr, int port)
 {
-	m_net->setAddrPort(addr, port);
+	ARCH_NET_CALL setAddrPort(addr, port);
 }
 
 int
 CArch::getAddrPort(CArchNetAddress addr)
 {
-	return m_net->getAddrPort(addr);
+	return ARCH_NET_CALL getAddrPort(addr);
 }
 
 bool
 CArch::isAnyAddr(CArchNetAddress addr)
 {
-	return m_net->isAnyAddr(addr);
+	return ARCH_NET_CALL isAnyAddr(addr);
 }
 
 bool
 CArch::isEqualAddr(CArchNetAddress a, CArchNetAddress b)
 {
-	return m_net->isEqualAddr(a, b);
+	return ARCH_NET_CALL isEqualAddr(a, b);
 }
 
 void
@@ -587,25 +652,31 @@ CArch::sleep(double timeout)
 int
 CArch::vsnprintf(char* str, int size, const char* fmt, va_list ap)
 {
-	return m_string->vsnprintf(str, size, fmt, ap);
+	return ARCH_STRING_CALL vsnprintf(str, size, fmt, ap);
 }
 
 int
 CArch::convStringMBToWC(wchar_t* dst, const char* src, UInt32 n, bool* errors)
 {
-	return m_string->convStringMBToWC(dst, src, n, errors);
+	return ARCH_STRING_CALL convStringMBToWC(dst, src, n, errors);
 }
 
 int
 CArch::convStringWCToMB(char* dst, const wchar_t* src, UInt32 n, bool* errors)
 {
-	return m_string->convStringWCToMB(dst, src, n, errors);
+	return ARCH_STRING_CALL convStringWCToMB(dst, src, n, errors);
 }
 
 IArchString::EWideCharEncoding
 CArch::getWideCharEncoding()
 {
-	return m_string->getWideCharEncoding();
+	return ARCH_STRING_CALL getWideCharEncoding();
+}
+
+bool
+CArch::lockMemory()
+{
+	return m_system->lockMemory();
 }
 
 std::string
@@ -635,5 +706,11 @@ CArch::updateReceiver(IArchTaskBarReceiver* receiver)
 double
 CArch::time()
 {
-	return m_time->time();
+	return ARCH_TIME_CALL time();
+}
+
+double
+CArch::coarseTime()
+{
+	return ARCH_TIME_CALL coarseTime();
 }
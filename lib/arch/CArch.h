@@ -35,6 +35,21 @@ This macro evaluates to the singleton CArch object.
 
 #define ARCH_ARGS void
 
+/*!
+\def ARCH_VIRTUAL
+Normally \c CArch implements every arch interface and \c ARCH calls go
+through a vtable.  When configured with \c --enable-static-arch the
+multithreading, network, string and time methods are instead ordinary
+member functions that call the platform implementation directly.  The
+\c IArch interfaces and their implementations are unchanged so they
+can still be used polymorphically, e.g. by tests.
+*/
+#if ARCH_STATIC_BINDING
+#	define ARCH_VIRTUAL
+#else
+#	define ARCH_VIRTUAL virtual
+#endif
+
 //! Delegating mplementation of architecture dependent interfaces
 /*!
 This class is a centralized interface to all architecture dependent
@@ -49,14 +64,29 @@ class CArch : public IArchConsole,
 				public IArchDaemon,
 				public IArchFile,
 				public IArchLog,
+#if !ARCH_STATIC_BINDING
 				public IArchMultithread,
 				public IArchNetwork,
-				public IArchSleep,
 				public IArchString,
+				public IArchTime,
+#endif
+				public IArchSleep,
 				public IArchSystem,
-				public IArchTaskBar,
-				public IArchTime {
+				public IArchTaskBar {
 public:
+#if ARCH_STATIC_BINDING
+	typedef IArchMultithread::ThreadFunc ThreadFunc;
+	typedef IArchMultithread::ThreadID ThreadID;
+	typedef IArchMultithread::ESignal ESignal;
+	typedef IArchMultithread::SignalFunc SignalFunc;
+	typedef IArchMultithread::ESchedulingPolicy ESchedulingPolicy;
+	typedef IArchNetwork::EAddressFamily EAddressFamily;
+	typedef IArchNetwork::ESocketType ESocketType;
+	typedef IArchNetwork::CPollEntry CPollEntry;
+	typedef IArchNetwork::CSocketError CSocketError;
+	typedef IArchString::EWideCharEncoding EWideCharEncoding;
+#endif
+
 	CArch(ARCH_ARGS* args = NULL);
 	~CArch();
 
@@ -104,75 +134,91 @@ public:
 	virtual void		writeLog(ELevel, const char*);
 
 	// IArchMultithread overrides
-	virtual CArchCond	newCondVar();
-	virtual void		closeCondVar(CArchCond);
-	virtual void		signalCondVar(CArchCond);
-	virtual void		broadcastCondVar(CArchCond);
-	virtual bool		waitCondVar(CArchCond, CArchMutex, double timeout);
-	virtual CArchMutex	newMutex();
-	virtual void		closeMutex(CArchMutex);
-	virtual void		lockMutex(CArchMutex);
-	virtual void		unlockMutex(CArchMutex);
-	virtual CArchThread	newThread(ThreadFunc, void*);
-	virtual CArchThread	newCurrentThread();
-	virtual CArchThread	copyThread(CArchThread);
-	virtual void		closeThread(CArchThread);
-	virtual void		cancelThread(CArchThread);
-	virtual void		setPriorityOfThread(CArchThread, int n);
-	virtual void		testCancelThread();
-	virtual bool		wait(CArchThread, double timeout);
-	virtual bool		isSameThread(CArchThread, CArchThread);
-	virtual bool		isExitedThread(CArchThread);
-	virtual void*		getResultOfThread(CArchThread);
-	virtual ThreadID	getIDOfThread(CArchThread);
-	virtual void		setSignalHandler(ESignal, SignalFunc, void*);
-	virtual void		raiseSignal(ESignal);
+	ARCH_VIRTUAL CArchCond	newCondVar();
+	ARCH_VIRTUAL void		closeCondVar(CArchCond);
+	ARCH_VIRTUAL void		signalCondVar(CArchCond);
+	ARCH_VIRTUAL void		broadcastCondVar(CArchCond);
+	ARCH_VIRTUAL bool		waitCondVar(CArchCond, CArchMutex, double timeout);
+	ARCH_VIRTUAL CArchMutex	newMutex();
+	ARCH_VIRTUAL void		closeMutex(CArchMutex);
+	ARCH_VIRTUAL void		lockMutex(CArchMutex);
+	ARCH_VIRTUAL void		unlockMutex(CArchMutex);
+	ARCH_VIRTUAL CArchThread	newThread(ThreadFunc, void*);
+	ARCH_VIRTUAL CArchThread	newCurrentThread();
+	ARCH_VIRTUAL CArchThread	copyThread(CArchThread);
+	ARCH_VIRTUAL void		closeThread(CArchThread);
+	ARCH_VIRTUAL void		cancelThread(CArchThread);
+	ARCH_VIRTUAL void		setPriorityOfThread(CArchThread, int n);
+	ARCH_VIRTUAL bool		setSchedulingOfThread(CArchThread,
+							ESchedulingPolicy, int priority);
+	ARCH_VIRTUAL bool		setAffinityOfThread(CArchThread,
+							const std::vector<int>& cpus);
+	ARCH_VIRTUAL void		testCancelThread();
+	ARCH_VIRTUAL bool		wait(CArchThread, double timeout);
+	ARCH_VIRTUAL bool		isSameThread(CArchThread, CArchThread);
+	ARCH_VIRTUAL bool		isExitedThread(CArchThread);
+	ARCH_VIRTUAL void*		getResultOfThread(CArchThread);
+	ARCH_VIRTUAL ThreadID	getIDOfThread(CArchThread);
+	ARCH_VIRTUAL ThreadID	getIDOfCurrentThread();
+	ARCH_VIRTUAL void		setSignalHandler(ESignal, SignalFunc, void*);
+	ARCH_VIRTUAL void		raiseSignal(ESignal);
 
 	// IArchNetwork overrides
-	virtual CArchSocket	newSocket(EAddressFamily, ESocketType);
-	virtual CArchSocket	copySocket(CArchSocket s);
-	virtual void		closeSocket(CArchSocket s);
-	virtual void		closeSocketForRead(CArchSocket s);
-	virtual void		closeSocketForWrite(CArchSocket s);
-	virtual void		bindSocket(CArchSocket s, CArchNetAddress addr);
-	virtual void		listenOnSocket(CArchSocket s);
-	virtual CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr);
-	virtual bool		connectSocket(CArchSocket s, CArchNetAddress name);
-	virtual int			pollSocket(CPollEntry[], int num, double timeout);
-	virtual void		unblockPollSocket(CArchThread thread);
-	virtual size_t		readSocket(CArchSocket s, void* buf, size_t len);
-	virtual size_t		writeSocket(CArchSocket s,
+	ARCH_VIRTUAL CArchSocket	newSocket(EAddressFamily, ESocketType);
+	ARCH_VIRTUAL CArchSocket	copySocket(CArchSocket s);
+	ARCH_VIRTUAL void		closeSocket(CArchSocket s);
+	ARCH_VIRTUAL void		closeSocketForRead(CArchSocket s);
+	ARCH_VIRTUAL void		closeSocketForWrite(CArchSocket s);
+	ARCH_VIRTUAL void		bindSocket(CArchSocket s, CArchNetAddress addr);
+	ARCH_VIRTUAL void		listenOnSocket(CArchSocket s);
+	ARCH_VIRTUAL CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr);
+	ARCH_VIRTUAL CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr,
+							CSocketError* error);
+	ARCH_VIRTUAL bool		connectSocket(CArchSocket s, CArchNetAddress name);
+	ARCH_VIRTUAL int			pollSocket(CPollEntry[], int num, double timeout);
+	ARCH_VIRTUAL int			pollSocket(CPollEntry[], int num, double timeout,
+							CSocketError* error);
+	ARCH_VIRTUAL void		unblockPollSocket(CArchThread thread);
+	ARCH_VIRTUAL size_t		readSocket(CArchSocket s, void* buf, size_t len);
+	ARCH_VIRTUAL size_t		writeSocket(CArchSocket s,
 							const void* buf, size_t len);
-	virtual void		throwErrorOnSocket(CArchSocket);
-	virtual bool		setNoDelayOnSocket(CArchSocket, bool noDelay);
-	virtual bool		setReuseAddrOnSocket(CArchSocket, bool reuse);
-	virtual std::string		getHostName();
-	virtual CArchNetAddress	newAnyAddr(EAddressFamily);
-	virtual CArchNetAddress	copyAddr(CArchNetAddress);
-	virtual CArchNetAddress	nameToAddr(const std::string&);
-	virtual void			closeAddr(CArchNetAddress);
-	virtual std::string		addrToName(CArchNetAddress);
-	virtual std::string		addrToString(CArchNetAddress);
-	virtual EAddressFamily	getAddrFamily(CArchNetAddress);
-	virtual void			setAddrPort(CArchNetAddress, int port);
-	virtual int				getAddrPort(CArchNetAddress);
-	virtual bool			isAnyAddr(CArchNetAddress);
-	virtual bool			isEqualAddr(CArchNetAddress, CArchNetAddress);
+	ARCH_VIRTUAL size_t		readSocket(CArchSocket s, void* buf, size_t len,
+							CSocketError* error);
+	ARCH_VIRTUAL size_t		writeSocket(CArchSocket s,
+							const void* buf, size_t len,
+							CSocketError* error);
+	ARCH_VIRTUAL void		throwErrorOnSocket(CArchSocket);
+	ARCH_VIRTUAL bool		getErrorOnSocket(CArchSocket, CSocketError* error);
+	ARCH_VIRTUAL bool		setNoDelayOnSocket(CArchSocket, bool noDelay);
+	ARCH_VIRTUAL bool		setReuseAddrOnSocket(CArchSocket, bool reuse);
+	ARCH_VIRTUAL std::string		getHostName();
+	ARCH_VIRTUAL CArchNetAddress	newAnyAddr(EAddressFamily);
+	ARCH_VIRTUAL CArchNetAddress	copyAddr(CArchNetAddress);
+	ARCH_VIRTUAL CArchNetAddress	nameToAddr(const std::string&);
+	ARCH_VIRTUAL void			closeAddr(CArchNetAddress);
+	ARCH_VIRTUAL std::string		addrToName(CArchNetAddress);
+	ARCH_VIRTUAL std::string		addrToString(CArchNetAddress);
+	ARCH_VIRTUAL EAddressFamily	getAddrFamily(CArchNetAddress);
+	ARCH_VIRTUAL void			setAddrPort(CArchNetAddress, int port);
+	ARCH_VIRTUAL int				getAddrPort(CArchNetAddress);
+	ARCH_VIRTUAL bool			isAnyAddr(CArchNetAddress);
+	ARCH_VIRTUAL bool			isEqualAddr(CArchNetAddress, CArchNetAddress);
 
 	// IArchSleep overrides
 	virtual void		sleep(double timeout);
 
 	// IArchString overrides
-	virtual int			vsnprintf(char* str,
+	ARCH_VIRTUAL int			vsnprintf(char* str,
 							int size, const char* fmt, va_list ap);
-	virtual int			convStringMBToWC(wchar_t*,
+	ARCH_VIRTUAL int			convStringMBToWC(wchar_t*,
 							const char*, UInt32 n, bool* errors);
-	virtual int			convStringWCToMB(char*,
+	ARCH_VIRTUAL int			convStringWCToMB(char*,
 							const wchar_t*, UInt32 n, bool* errors);
-	virtual EWideCharEncoding
+	ARCH_VIRTUAL EWideCharEncoding
 						getWideCharEncoding();
 
 	// IArchSystem overrides
+	virtual bool		lockMemory();
 	virtual std::string	getOSName() const;
 
 	// IArchTaskBar
@@ -181,7 +227,8 @@ public:
 	virtual void		updateReceiver(IArchTaskBarReceiver*);
 
 	// IArchTime overrides
-	virtual double		time();
+	ARCH_VIRTUAL double		time();
+	ARCH_VIRTUAL double		coarseTime();
 
 private:
 	static CArch*		s_instance;
@@ -16,6 +16,8 @@
 #include "CArch.h"
 #include "XArch.h"
 #include <signal.h>
+#include <sched.h>
+#include <sys/resource.h>
 #if TIME_WITH_SYS_TIME
 #	include <sys/time.h>
 #	include <time.h>
@@ -66,7 +68,7 @@ public:
 	pthread_t			m_thread;
 	IArchMultithread::ThreadFunc	m_func;
 	void*				m_userData;
-	bool				m_cancel;
+	volatile bool		m_cancel;
 	bool				m_cancelling;
 	bool				m_exited;
 	void*				m_result;
@@ -111,11 +113,17 @@ CArchMultithreadPosix::CArchMultithreadPosix() :
 	// create mutex for thread list
 	m_threadMutex = newMutex();
 
-	// create thread for calling (main) thread and add it to our
-	// list.  no need to lock the mutex since we're the only thread.
+	// each thread finds its CArchThreadImpl through thread local
+	// storage so looking up the current thread doesn't need a lock
+	int status = pthread_key_create(&m_threadKey, NULL);
+	assert(status == 0);
+
+	// create thread for calling (main) thread.  no need to lock the
+	// mutex since we're the only thread.
 	m_mainThread           = new CArchThreadImpl;
 	m_mainThread->m_thread = pthread_self();
 	insert(m_mainThread);
+	pthread_setspecific(m_threadKey, m_mainThread);
 
 	// install SIGWAKEUP handler.  this causes SIGWAKEUP to interrupt
 	// system calls.  we use that when cancelling a thread to force it
@@ -147,6 +155,7 @@ CArchMultithreadPosix::~CArchMultithreadPosix()
 {
 	assert(s_instance != NULL);
 
+	pthread_key_delete(m_threadKey);
 	closeMutex(m_threadMutex);
 	s_instance = NULL;
 }
@@ -154,8 +163,8 @@ CArchMultithreadPosix::~CArchMultithreadPosix()
 void
 CArchMultithreadPosix::setNetworkDataForCurrentThread(void* data)
 {
+	CArchThreadImpl* thread = findCurrentNoRef();
 	lockMutex(m_threadMutex);
-	CArchThreadImpl* thread = find(pthread_self());
 	thread->m_networkData = data;
 	unlockMutex(m_threadMutex);
 }
@@ -374,7 +383,7 @@ CArchMultithreadPosix::newThread(ThreadFunc func, void* data)
 		thread = NULL;
 	}
 	else {
-		// add thread to list
+		// give thread an id
 		insert(thread);
 
 		// increment ref count to account for the thread itself
@@ -390,9 +399,7 @@ CArchMultithreadPosix::newThread(ThreadFunc func, void* data)
 CArchThread
 CArchMultithreadPosix::newCurrentThread()
 {
-	lockMutex(m_threadMutex);
-	CArchThreadImpl* thread = find(pthread_self());
-	unlockMutex(m_threadMutex);
+	CArchThreadImpl* thread = findCurrent();
 	assert(thread != NULL);
 	return thread;
 }
@@ -409,12 +416,6 @@ CArchMultithreadPosix::closeThread(CArchThread thread)
 			pthread_detach(thread->m_thread);
 		}
 
-		// remove thread from list
-		lockMutex(m_threadMutex);
-		assert(findNoRef(thread->m_thread) == thread);
-		erase(thread);
-		unlockMutex(m_threadMutex);
-
 		// done with thread
 		delete thread;
 	}
@@ -448,23 +449,111 @@ CArchMultithreadPosix::cancelThread(CArchThread thread)
 }
 
 void
-CArchMultithreadPosix::setPriorityOfThread(CArchThread thread, int /*n*/)
+CArchMultithreadPosix::setPriorityOfThread(CArchThread thread, int n)
+{
+	assert(thread != NULL);
+
+	// only real-time priorities are changed.  an unprivileged process
+	// can't take back a nice value it gives up so we leave time sharing
+	// threads alone.  use setSchedulingOfThread() for those.
+	int policy;
+	struct sched_param param;
+	if (pthread_getschedparam(thread->m_thread, &policy, &param) != 0 ||
+		(policy != SCHED_FIFO && policy != SCHED_RR)) {
+		return;
+	}
+	int priority = param.sched_priority - n;
+	int minimum  = sched_get_priority_min(policy);
+	int maximum  = sched_get_priority_max(policy);
+	if (priority < minimum) {
+		priority = minimum;
+	}
+	else if (priority > maximum) {
+		priority = maximum;
+	}
+	param.sched_priority = priority;
+	pthread_setschedparam(thread->m_thread, policy, &param);
+}
+
+bool
+CArchMultithreadPosix::setSchedulingOfThread(CArchThread thread,
+				ESchedulingPolicy policy, int priority)
+{
+	assert(thread != NULL);
+
+	struct sched_param param;
+	int posixPolicy;
+	switch (policy) {
+	case kSchedulingRoundRobin:
+		posixPolicy = SCHED_RR;
+		break;
+
+	case kSchedulingFIFO:
+		posixPolicy = SCHED_FIFO;
+		break;
+
+	default:
+		posixPolicy = SCHED_OTHER;
+		break;
+	}
+	if (posixPolicy == SCHED_OTHER) {
+		// the nice value can only be set for the calling thread.  on
+		// linux it's per thread, elsewhere it may be per process.
+		if (!pthread_equal(thread->m_thread, pthread_self())) {
+			return false;
+		}
+		param.sched_priority = 0;
+	}
+	else {
+		int minimum = sched_get_priority_min(posixPolicy);
+		int maximum = sched_get_priority_max(posixPolicy);
+		if (priority < minimum) {
+			priority = minimum;
+		}
+		else if (priority > maximum) {
+			priority = maximum;
+		}
+		param.sched_priority = priority;
+	}
+
+	// real-time policies usually need privileges
+	if (pthread_setschedparam(thread->m_thread, posixPolicy, &param) != 0) {
+		return false;
+	}
+	if (posixPolicy == SCHED_OTHER &&
+		setpriority(PRIO_PROCESS, 0, priority) != 0) {
+		return false;
+	}
+	return true;
+}
+
+bool
+CArchMultithreadPosix::setAffinityOfThread(CArchThread thread,
+				const std::vector<int>& cpus)
 {
 	assert(thread != NULL);
 
-	// FIXME
+#if HAVE_PTHREAD_SETAFFINITY_NP
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (std::vector<int>::const_iterator i = cpus.begin();
+								i != cpus.end(); ++i) {
+		if (*i < 0 || *i >= CPU_SETSIZE) {
+			return false;
+		}
+		CPU_SET(*i, &set);
+	}
+	return (pthread_setaffinity_np(thread->m_thread, sizeof(set), &set) == 0);
+#else
+	(void)cpus;
+	return false;
+#endif
 }
 
 void
 CArchMultithreadPosix::testCancelThread()
 {
-	// find current thread
-	lockMutex(m_threadMutex);
-	CArchThreadImpl* thread = findNoRef(pthread_self());
-	unlockMutex(m_threadMutex);
-
-	// test cancel on thread
-	testCancelThreadImpl(thread);
+	testCancelThreadImpl(findCurrentNoRef());
 }
 
 bool
@@ -475,7 +564,7 @@ CArchMultithreadPosix::wait(CArchThread target, double timeout)
 	lockMutex(m_threadMutex);
 
 	// find current thread
-	CArchThreadImpl* self = findNoRef(pthread_self());
+	CArchThreadImpl* self = findCurrentNoRef();
 
 	// ignore wait if trying to wait on ourself
 	if (target == self) {
@@ -553,6 +642,13 @@ CArchMultithreadPosix::getIDOfThread(CArchThread thread)
 	return thread->m_id;
 }
 
+IArchMultithread::ThreadID
+CArchMultithreadPosix::getIDOfCurrentThread()
+{
+	CArchThreadImpl* thread = findCurrentNoRef();
+	return (thread == NULL) ? 0 : thread->m_id;
+}
+
 void
 CArchMultithreadPosix::setSignalHandler(
 				ESignal signal, SignalFunc func, void* userData)
@@ -606,9 +702,9 @@ CArchMultithreadPosix::startSignalHandler()
 }
 
 CArchThreadImpl*
-CArchMultithreadPosix::find(pthread_t thread)
+CArchMultithreadPosix::findCurrent()
 {
-	CArchThreadImpl* impl = findNoRef(thread);
+	CArchThreadImpl* impl = findCurrentNoRef();
 	if (impl != NULL) {
 		refThread(impl);
 	}
@@ -616,16 +712,11 @@ CArchMultithreadPosix::find(pthread_t thread)
 }
 
 CArchThreadImpl*
-CArchMultithreadPosix::findNoRef(pthread_t thread)
+CArchMultithreadPosix::findCurrentNoRef()
 {
-	// linear search
-	for (CThreadList::const_iterator index  = m_threadList.begin();
-									 index != m_threadList.end(); ++index) {
-		if ((*index)->m_thread == thread) {
-			return *index;
-		}
-	}
-	return NULL;
+	// threads we didn't create have no CArchThreadImpl
+	return reinterpret_cast<CArchThreadImpl*>(
+							pthread_getspecific(m_threadKey));
 }
 
 void
@@ -633,36 +724,18 @@ CArchMultithreadPosix::insert(CArchThreadImpl* thread)
 {
 	assert(thread != NULL);
 
-	// thread shouldn't already be on the list
-	assert(findNoRef(thread->m_thread) == NULL);
-
 	// set thread id.  note that we don't worry about m_nextID
 	// wrapping back to 0 and duplicating thread ID's since the
 	// likelihood of synergy running that long is vanishingly
 	// small.
 	thread->m_id = ++m_nextID;
-
-	// append to list
-	m_threadList.push_back(thread);
-}
-
-void
-CArchMultithreadPosix::erase(CArchThreadImpl* thread)
-{
-	for (CThreadList::iterator index  = m_threadList.begin();
-							   index != m_threadList.end(); ++index) {
-		if (*index == thread) {
-			m_threadList.erase(index);
-			break;
-		}
-	}
 }
 
 void
 CArchMultithreadPosix::refThread(CArchThreadImpl* thread)
 {
 	assert(thread != NULL);
-	assert(findNoRef(thread->m_thread) != NULL);
+	assert(thread->m_refCount > 0);
 	++thread->m_refCount;
 }
 
@@ -671,6 +744,12 @@ CArchMultithreadPosix::testCancelThreadImpl(CArchThreadImpl* thread)
 {
 	assert(thread != NULL);
 
+	// cancelThread() sets m_cancel before waking the thread so we can
+	// skip the lock in the common case of no cancellation
+	if (!thread->m_cancel) {
+		return;
+	}
+
 	// update cancel state
 	lockMutex(m_threadMutex);
 	bool cancel = false;
@@ -692,6 +771,7 @@ CArchMultithreadPosix::threadFunc(void* vrep)
 {
 	// get the thread
 	CArchThreadImpl* thread = reinterpret_cast<CArchThreadImpl*>(vrep);
+	pthread_setspecific(s_instance->m_threadKey, thread);
 
 	// setup pthreads
 	pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, NULL);
@@ -16,7 +16,6 @@
 #define CARCHMULTITHREADPOSIX_H
 
 #include "IArchMultithread.h"
-#include "stdlist.h"
 #include <pthread.h>
 
 #define ARCH_MULTITHREAD CArchMultithreadPosix
@@ -68,22 +67,26 @@ public:
 	virtual void		closeThread(CArchThread);
 	virtual void		cancelThread(CArchThread);
 	virtual void		setPriorityOfThread(CArchThread, int n);
+	virtual bool		setSchedulingOfThread(CArchThread,
+							ESchedulingPolicy, int priority);
+	virtual bool		setAffinityOfThread(CArchThread,
+							const std::vector<int>& cpus);
 	virtual void		testCancelThread();
 	virtual bool		wait(CArchThread, double timeout);
 	virtual bool		isSameThread(CArchThread, CArchThread);
 	virtual bool		isExitedThread(CArchThread);
 	virtual void*		getResultOfThread(CArchThread);
 	virtual ThreadID	getIDOfThread(CArchThread);
+	virtual ThreadID	getIDOfCurrentThread();
 	virtual void		setSignalHandler(ESignal, SignalFunc, void*);
 	virtual void		raiseSignal(ESignal);
 
 private:
 	void				startSignalHandler();
 
-	CArchThreadImpl*	find(pthread_t thread);
-	CArchThreadImpl*	findNoRef(pthread_t thread);
+	CArchThreadImpl*	findCurrent();
+	CArchThreadImpl*	findCurrentNoRef();
 	void				insert(CArchThreadImpl* thread);
-	void				erase(CArchThreadImpl* thread);
 
 	void				refThread(CArchThreadImpl* rep);
 	void				testCancelThreadImpl(CArchThreadImpl* rep);
@@ -94,15 +97,13 @@ private:
 	static void*		threadSignalHandler(void* vrep);
 
 private:
-	typedef std::list<CArchThread> CThreadList;
-
 	static CArchMultithreadPosix*	s_instance;
 
 	bool				m_newThreadCalled;
 
 	CArchMutex			m_threadMutex;
 	CArchThread			m_mainThread;
-	CThreadList			m_threadList;
+	pthread_key_t		m_threadKey;
 	ThreadID			m_nextID;
 
 	pthread_t			m_signalThread;
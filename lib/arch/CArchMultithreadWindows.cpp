@@ -430,6 +430,33 @@ CArchMultithreadWindows::setPriorityOfThread(CArchThread thread, int n)
 	SetThreadPriority(thread->m_thread, s_pClass[index].m_level);
 }
 
+bool
+CArchMultithreadWindows::setSchedulingOfThread(CArchThread thread,
+				ESchedulingPolicy, int)
+{
+	assert(thread != NULL);
+
+	// not supported.  use setPriorityOfThread().
+	return false;
+}
+
+bool
+CArchMultithreadWindows::setAffinityOfThread(CArchThread thread,
+				const std::vector<int>& cpus)
+{
+	assert(thread != NULL);
+
+	DWORD_PTR mask = 0;
+	for (std::vector<int>::const_iterator i = cpus.begin();
+								i != cpus.end(); ++i) {
+		if (*i < 0 || *i >= static_cast<int>(8 * sizeof(mask))) {
+			return false;
+		}
+		mask |= (static_cast<DWORD_PTR>(1) << *i);
+	}
+	return (SetThreadAffinityMask(thread->m_thread, mask) != 0);
+}
+
 void
 CArchMultithreadWindows::testCancelThread()
 {
@@ -532,6 +559,12 @@ CArchMultithreadWindows::getIDOfThread(CArchThread thread)
 	return static_cast<ThreadID>(thread->m_id);
 }
 
+IArchMultithread::ThreadID
+CArchMultithreadWindows::getIDOfCurrentThread()
+{
+	return static_cast<ThreadID>(GetCurrentThreadId());
+}
+
 void
 CArchMultithreadWindows::setSignalHandler(
 				ESignal signal, SignalFunc func, void* userData)
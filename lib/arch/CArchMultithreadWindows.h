@@ -76,12 +76,17 @@ public:
 	virtual void		closeThread(CArchThread);
 	virtual void		cancelThread(CArchThread);
 	virtual void		setPriorityOfThread(CArchThread, int n);
+	virtual bool		setSchedulingOfThread(CArchThread,
+							ESchedulingPolicy, int priority);
+	virtual bool		setAffinityOfThread(CArchThread,
+							const std::vector<int>& cpus);
 	virtual void		testCancelThread();
 	virtual bool		wait(CArchThread, double timeout);
 	virtual bool		isSameThread(CArchThread, CArchThread);
 	virtual bool		isExitedThread(CArchThread);
 	virtual void*		getResultOfThread(CArchThread);
 	virtual ThreadID	getIDOfThread(CArchThread);
+	virtual ThreadID	getIDOfCurrentThread();
 	virtual void		setSignalHandler(ESignal, SignalFunc, void*);
 	virtual void		raiseSignal(ESignal);
 
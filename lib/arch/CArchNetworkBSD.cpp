@@ -199,7 +199,20 @@ CArchNetworkBSD::listenOnSocket(CArchSocket s)
 CArchSocket
 CArchNetworkBSD::acceptSocket(CArchSocket s, CArchNetAddress* addr)
 {
-	assert(s != NULL);
+	CSocketError error;
+	CArchSocket newSocket = acceptSocket(s, addr, &error);
+	if (error.m_type != kSocketOK) {
+		throwError(error.m_error);
+	}
+	return newSocket;
+}
+
+CArchSocket
+CArchNetworkBSD::acceptSocket(CArchSocket s, CArchNetAddress* addr,
+				CSocketError* error)
+{
+	assert(s     != NULL);
+	assert(error != NULL);
 
 	// if user passed NULL in addr then use scratch space
 	CArchNetAddress dummy;
@@ -220,21 +233,22 @@ CArchNetworkBSD::acceptSocket(CArchSocket s, CArchNetAddress* addr)
 		delete newSocket;
 		delete *addr;
 		*addr = NULL;
-		if (err == EAGAIN) {
-			return NULL;
+		if (err != EAGAIN) {
+			setError(error, err);
 		}
-		throwError(err);
+		return NULL;
 	}
 
-	try {
-		setBlockingOnSocket(fd, false);
-	}
-	catch (...) {
+	// make the new socket non-blocking.  this is setBlockingOnSocket()
+	// without the exception.
+	int mode = fcntl(fd, F_GETFL, 0);
+	if (mode == -1 || fcntl(fd, F_SETFL, mode | O_NONBLOCK) == -1) {
+		setError(error, errno);
 		close(fd);
 		delete newSocket;
 		delete *addr;
 		*addr = NULL;
-		throw;
+		return NULL;
 	}
 
 	// initialize socket
@@ -270,9 +284,11 @@ CArchNetworkBSD::connectSocket(CArchSocket s, CArchNetAddress addr)
 #if HAVE_POLL
 
 int
-CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout)
+CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout,
+				CSocketError* error)
 {
 	assert(pe != NULL || num == 0);
+	assert(error != NULL);
 
 	// return if nothing to do
 	if (num == 0) {
@@ -332,8 +348,9 @@ CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout)
 			delete[] pfd;
 			return 0;
 		}
+		setError(error, errno);
 		delete[] pfd;
-		throwError(errno);
+		return 0;
 	}
 
 	// translate back
@@ -360,8 +377,10 @@ CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout)
 #else
 
 int
-CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout)
+CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout,
+				CSocketError* error)
 {
+	assert(error != NULL);
 	int i, n;
 
 	// prepare sets for select
@@ -458,7 +477,8 @@ CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout)
 			ARCH->testCancelThread();
 			return 0;
 		}
-		throwError(errno);
+		setError(error, errno);
+		return 0;
 	}
 	n = 0;
 	for (i = 0; i < num; ++i) {
@@ -483,6 +503,17 @@ CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout)
 
 #endif
 
+int
+CArchNetworkBSD::pollSocket(CPollEntry pe[], int num, double timeout)
+{
+	CSocketError error;
+	int n = pollSocket(pe, num, timeout, &error);
+	if (error.m_type != kSocketOK) {
+		throwError(error.m_error);
+	}
+	return n;
+}
+
 void
 CArchNetworkBSD::unblockPollSocket(CArchThread thread)
 {
@@ -496,29 +527,55 @@ CArchNetworkBSD::unblockPollSocket(CArchThread thread)
 size_t
 CArchNetworkBSD::readSocket(CArchSocket s, void* buf, size_t len)
 {
-	assert(s != NULL);
+	CSocketError error;
+	size_t n = readSocket(s, buf, len, &error);
+	if (error.m_type != kSocketOK) {
+		throwError(error.m_error);
+	}
+	return n;
+}
+
+size_t
+CArchNetworkBSD::writeSocket(CArchSocket s, const void* buf, size_t len)
+{
+	CSocketError error;
+	size_t n = writeSocket(s, buf, len, &error);
+	if (error.m_type != kSocketOK) {
+		throwError(error.m_error);
+	}
+	return n;
+}
+
+size_t
+CArchNetworkBSD::readSocket(CArchSocket s, void* buf, size_t len,
+				CSocketError* error)
+{
+	assert(s     != NULL);
+	assert(error != NULL);
 
 	ssize_t n = read(s->m_fd, buf, len);
 	if (n == -1) {
-		if (errno == EINTR || errno == EAGAIN) {
-			return 0;
+		if (errno != EINTR && errno != EAGAIN) {
+			setError(error, errno);
 		}
-		throwError(errno);
+		return 0;
 	}
 	return n;
 }
 
 size_t
-CArchNetworkBSD::writeSocket(CArchSocket s, const void* buf, size_t len)
+CArchNetworkBSD::writeSocket(CArchSocket s, const void* buf, size_t len,
+				CSocketError* error)
 {
-	assert(s != NULL);
+	assert(s     != NULL);
+	assert(error != NULL);
 
 	ssize_t n = write(s->m_fd, buf, len);
 	if (n == -1) {
-		if (errno == EINTR || errno == EAGAIN) {
-			return 0;
+		if (errno != EINTR && errno != EAGAIN) {
+			setError(error, errno);
 		}
-		throwError(errno);
+		return 0;
 	}
 	return n;
 }
@@ -526,7 +583,17 @@ CArchNetworkBSD::writeSocket(CArchSocket s, const void* buf, size_t len)
 void
 CArchNetworkBSD::throwErrorOnSocket(CArchSocket s)
 {
-	assert(s != NULL);
+	CSocketError error;
+	if (getErrorOnSocket(s, &error)) {
+		throwError(error.m_error);
+	}
+}
+
+bool
+CArchNetworkBSD::getErrorOnSocket(CArchSocket s, CSocketError* error)
+{
+	assert(s     != NULL);
+	assert(error != NULL);
 
 	// get the error from the socket layer
 	int err        = 0;
@@ -536,10 +603,11 @@ CArchNetworkBSD::throwErrorOnSocket(CArchSocket s)
 		err = errno;
 	}
 
-	// throw if there's an error
 	if (err != 0) {
-		throwError(err);
+		setError(error, err);
+		return true;
 	}
+	return false;
 }
 
 void
@@ -944,6 +1012,32 @@ CArchNetworkBSD::throwError(int err)
 	}
 }
 
+void
+CArchNetworkBSD::setError(CSocketError* error, int err)
+{
+	switch (err) {
+	case EINTR:
+		ARCH->testCancelThread();
+		error->m_type = kSocketFailed;
+		break;
+
+	case EPIPE:
+		error->m_type = kSocketShutdown;
+		break;
+
+	case ECONNABORTED:
+	case ECONNRESET:
+		error->m_type = kSocketDisconnected;
+		break;
+
+	default:
+		error->m_type = kSocketFailed;
+		break;
+	}
+	error->m_error = err;
+	error->m_what  = XArchEvalUnix(err).eval();
+}
+
 void
 CArchNetworkBSD::throwNameError(int err)
 {
@@ -65,13 +65,23 @@ public:
 	virtual void		bindSocket(CArchSocket s, CArchNetAddress addr);
 	virtual void		listenOnSocket(CArchSocket s);
 	virtual CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr);
+	virtual CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr,
+							CSocketError* error);
 	virtual bool		connectSocket(CArchSocket s, CArchNetAddress name);
 	virtual int			pollSocket(CPollEntry[], int num, double timeout);
+	virtual int			pollSocket(CPollEntry[], int num, double timeout,
+							CSocketError* error);
 	virtual void		unblockPollSocket(CArchThread thread);
 	virtual size_t		readSocket(CArchSocket s, void* buf, size_t len);
 	virtual size_t		writeSocket(CArchSocket s,
 							const void* buf, size_t len);
+	virtual size_t		readSocket(CArchSocket s, void* buf, size_t len,
+							CSocketError* error);
+	virtual size_t		writeSocket(CArchSocket s,
+							const void* buf, size_t len,
+							CSocketError* error);
 	virtual void		throwErrorOnSocket(CArchSocket);
+	virtual bool		getErrorOnSocket(CArchSocket, CSocketError* error);
 	virtual bool		setNoDelayOnSocket(CArchSocket, bool noDelay);
 	virtual bool		setReuseAddrOnSocket(CArchSocket, bool reuse);
 	virtual std::string		getHostName();
@@ -92,6 +102,7 @@ private:
 	const int*			getUnblockPipeForThread(CArchThread);
 	void				setBlockingOnSocket(int fd, bool blocking);
 	void				throwError(int);
+	void				setError(CSocketError*, int);
 	void				throwNameError(int);
 
 private:
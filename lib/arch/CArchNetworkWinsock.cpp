@@ -296,7 +296,20 @@ CArchNetworkWinsock::listenOnSocket(CArchSocket s)
 CArchSocket
 CArchNetworkWinsock::acceptSocket(CArchSocket s, CArchNetAddress* addr)
 {
-	assert(s != NULL);
+	CSocketError error;
+	CArchSocket socket = acceptSocket(s, addr, &error);
+	if (error.m_type != kSocketOK) {
+		throwError(error.m_error);
+	}
+	return socket;
+}
+
+CArchSocket
+CArchNetworkWinsock::acceptSocket(CArchSocket s, CArchNetAddress* addr,
+				CSocketError* error)
+{
+	assert(s     != NULL);
+	assert(error != NULL);
 
 	// create new socket and temporary address
 	CArchSocketImpl* socket = new CArchSocketImpl;
@@ -309,21 +322,22 @@ CArchNetworkWinsock::acceptSocket(CArchSocket s, CArchNetAddress* addr)
 		delete socket;
 		free(tmp);
 		*addr = NULL;
-		if (err == WSAEWOULDBLOCK) {
-			return NULL;
+		if (err != WSAEWOULDBLOCK) {
+			setError(error, err);
 		}
-		throwError(err);
+		return NULL;
 	}
 
-	try {
-		setBlockingOnSocket(fd, false);
-	}
-	catch (...) {
+	// make the new socket non-blocking.  this is setBlockingOnSocket()
+	// without the exception.
+	int flag = 1;
+	if (ioctl_winsock(fd, FIONBIO, &flag) == SOCKET_ERROR) {
+		setError(error, getsockerror_winsock());
 		close_winsock(fd);
 		delete socket;
 		free(tmp);
 		*addr = NULL;
-		throw;
+		return NULL;
 	}
 
 	// initialize socket
@@ -363,6 +377,20 @@ CArchNetworkWinsock::connectSocket(CArchSocket s, CArchNetAddress addr)
 int
 CArchNetworkWinsock::pollSocket(CPollEntry pe[], int num, double timeout)
 {
+	CSocketError error;
+	int n = pollSocket(pe, num, timeout, &error);
+	if (error.m_type != kSocketOK) {
+		throwError(error.m_error);
+	}
+	return n;
+}
+
+int
+CArchNetworkWinsock::pollSocket(CPollEntry pe[], int num, double timeout,
+				CSocketError* error)
+{
+	assert(error != NULL);
+
 	int i;
 	DWORD n;
 
@@ -446,7 +474,8 @@ CArchNetworkWinsock::pollSocket(CPollEntry pe[], int num, double timeout)
 			ARCH->testCancelThread();
 			return 0;
 		}
-		throwError(getsockerror_winsock());
+		setError(error, getsockerror_winsock());
+		return 0;
 	}
 	if (result == WSA_WAIT_TIMEOUT && !canWrite) {
 		return 0;
@@ -525,35 +554,60 @@ CArchNetworkWinsock::unblockPollSocket(CArchThread thread)
 size_t
 CArchNetworkWinsock::readSocket(CArchSocket s, void* buf, size_t len)
 {
-	assert(s != NULL);
+	CSocketError error;
+	size_t n = readSocket(s, buf, len, &error);
+	if (error.m_type != kSocketOK) {
+		throwError(error.m_error);
+	}
+	return n;
+}
+
+size_t
+CArchNetworkWinsock::writeSocket(CArchSocket s, const void* buf, size_t len)
+{
+	CSocketError error;
+	size_t n = writeSocket(s, buf, len, &error);
+	if (error.m_type != kSocketOK) {
+		throwError(error.m_error);
+	}
+	return n;
+}
+
+size_t
+CArchNetworkWinsock::readSocket(CArchSocket s, void* buf, size_t len,
+				CSocketError* error)
+{
+	assert(s     != NULL);
+	assert(error != NULL);
 
 	int n = recv_winsock(s->m_socket, buf, len, 0);
 	if (n == SOCKET_ERROR) {
 		int err = getsockerror_winsock();
-		if (err == WSAEINTR || err == WSAEWOULDBLOCK) {
-			return 0;
+		if (err != WSAEINTR && err != WSAEWOULDBLOCK) {
+			setError(error, err);
 		}
-		throwError(err);
+		return 0;
 	}
 	return static_cast<size_t>(n);
 }
 
 size_t
-CArchNetworkWinsock::writeSocket(CArchSocket s, const void* buf, size_t len)
+CArchNetworkWinsock::writeSocket(CArchSocket s, const void* buf, size_t len,
+				CSocketError* error)
 {
-	assert(s != NULL);
+	assert(s     != NULL);
+	assert(error != NULL);
 
 	int n = send_winsock(s->m_socket, buf, len, 0);
 	if (n == SOCKET_ERROR) {
 		int err = getsockerror_winsock();
-		if (err == WSAEINTR) {
-			return 0;
-		}
 		if (err == WSAEWOULDBLOCK) {
 			s->m_pollWrite = true;
-			return 0;
 		}
-		throwError(err);
+		else if (err != WSAEINTR) {
+			setError(error, err);
+		}
+		return 0;
 	}
 	return static_cast<size_t>(n);
 }
@@ -561,7 +615,17 @@ CArchNetworkWinsock::writeSocket(CArchSocket s, const void* buf, size_t len)
 void
 CArchNetworkWinsock::throwErrorOnSocket(CArchSocket s)
 {
-	assert(s != NULL);
+	CSocketError error;
+	if (getErrorOnSocket(s, &error)) {
+		throwError(error.m_error);
+	}
+}
+
+bool
+CArchNetworkWinsock::getErrorOnSocket(CArchSocket s, CSocketError* error)
+{
+	assert(s     != NULL);
+	assert(error != NULL);
 
 	// get the error from the socket layer
 	int err  = 0;
@@ -571,10 +635,11 @@ CArchNetworkWinsock::throwErrorOnSocket(CArchSocket s)
 		err = getsockerror_winsock();
 	}
 
-	// throw if there's an error
 	if (err != 0) {
-		throwError(err);
+		setError(error, err);
+		return true;
 	}
+	return false;
 }
 
 void
@@ -912,6 +977,28 @@ CArchNetworkWinsock::throwError(int err)
 	}
 }
 
+void
+CArchNetworkWinsock::setError(CSocketError* error, int err)
+{
+	switch (err) {
+	case WSAEDISCON:
+		error->m_type = kSocketShutdown;
+		break;
+
+	case WSAENETRESET:
+	case WSAECONNABORTED:
+	case WSAECONNRESET:
+		error->m_type = kSocketDisconnected;
+		break;
+
+	default:
+		error->m_type = kSocketFailed;
+		break;
+	}
+	error->m_error = err;
+	error->m_what  = XArchEvalWinsock(err).eval();
+}
+
 void
 CArchNetworkWinsock::throwNameError(int err)
 {
@@ -62,13 +62,23 @@ public:
 	virtual void		bindSocket(CArchSocket s, CArchNetAddress addr);
 	virtual void		listenOnSocket(CArchSocket s);
 	virtual CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr);
+	virtual CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr,
+							CSocketError* error);
 	virtual bool		connectSocket(CArchSocket s, CArchNetAddress name);
 	virtual int			pollSocket(CPollEntry[], int num, double timeout);
+	virtual int			pollSocket(CPollEntry[], int num, double timeout,
+							CSocketError* error);
 	virtual void		unblockPollSocket(CArchThread thread);
 	virtual size_t		readSocket(CArchSocket s, void* buf, size_t len);
 	virtual size_t		writeSocket(CArchSocket s,
 							const void* buf, size_t len);
+	virtual size_t		readSocket(CArchSocket s, void* buf, size_t len,
+							CSocketError* error);
+	virtual size_t		writeSocket(CArchSocket s,
+							const void* buf, size_t len,
+							CSocketError* error);
 	virtual void		throwErrorOnSocket(CArchSocket);
+	virtual bool		getErrorOnSocket(CArchSocket, CSocketError* error);
 	virtual bool		setNoDelayOnSocket(CArchSocket, bool noDelay);
 	virtual bool		setReuseAddrOnSocket(CArchSocket, bool reuse);
 	virtual std::string		getHostName();
@@ -90,6 +100,7 @@ private:
 	void				setBlockingOnSocket(SOCKET, bool blocking);
 
 	void				throwError(int);
+	void				setError(CSocketError*, int);
 	void				throwNameError(int);
 
 private:
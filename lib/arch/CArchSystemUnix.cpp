@@ -14,6 +14,9 @@
 
 #include "CArchSystemUnix.h"
 #include <sys/utsname.h>
+#if HAVE_MLOCKALL
+#	include <sys/mman.h>
+#endif
 
 //
 // CArchSystemUnix
@@ -29,6 +32,16 @@ CArchSystemUnix::~CArchSystemUnix()
 	// do nothing
 }
 
+bool
+CArchSystemUnix::lockMemory()
+{
+#if HAVE_MLOCKALL
+	return (mlockall(MCL_CURRENT | MCL_FUTURE) == 0);
+#else
+	return false;
+#endif
+}
+
 std::string
 CArchSystemUnix::getOSName() const
 {
@@ -26,6 +26,7 @@ public:
 	virtual ~CArchSystemUnix();
 
 	// IArchSystem overrides
+	virtual bool		lockMemory();
 	virtual std::string	getOSName() const;
 };
 
@@ -31,6 +31,13 @@ CArchSystemWindows::~CArchSystemWindows()
 	// do nothing
 }
 
+bool
+CArchSystemWindows::lockMemory()
+{
+	// not supported
+	return false;
+}
+
 std::string
 CArchSystemWindows::getOSName() const
 {
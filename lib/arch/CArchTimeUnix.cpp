@@ -24,6 +24,15 @@
 #	endif
 #endif
 
+// use the monotonic clock if we have it.  on linux clock_gettime() is
+// handled in user space (by the vDSO) so it's as cheap as gettimeofday().
+#if HAVE_CLOCK_GETTIME && defined(CLOCK_MONOTONIC)
+#	define USE_MONOTONIC_CLOCK 1
+#	if defined(CLOCK_MONOTONIC_COARSE)
+#		define USE_MONOTONIC_COARSE_CLOCK 1
+#	endif
+#endif
+
 //
 // CArchTimeUnix
 //
@@ -41,7 +50,25 @@ CArchTimeUnix::~CArchTimeUnix()
 double
 CArchTimeUnix::time()
 {
+#if USE_MONOTONIC_CLOCK
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (double)t.tv_sec + 1.0e-9 * (double)t.tv_nsec;
+#else
 	struct timeval t;
 	gettimeofday(&t, NULL);
 	return (double)t.tv_sec + 1.0e-6 * (double)t.tv_usec;
+#endif
+}
+
+double
+CArchTimeUnix::coarseTime()
+{
+#if USE_MONOTONIC_COARSE_CLOCK
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &t);
+	return (double)t.tv_sec + 1.0e-9 * (double)t.tv_nsec;
+#else
+	return time();
+#endif
 }
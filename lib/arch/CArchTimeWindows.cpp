@@ -84,3 +84,11 @@ CArchTimeWindows::time()
 		return 0.001 * static_cast<double>(GetTickCount());
 	}
 }
+
+double
+CArchTimeWindows::coarseTime()
+{
+	// the performance counter is already cheap and the tick count
+	// doesn't share its starting time
+	return time();
+}
@@ -27,6 +27,7 @@ public:
 
 	// IArchTime overrides
 	virtual double		time();
+	virtual double		coarseTime();
 };
 
 #endif
@@ -50,30 +50,234 @@ wctomb(char* dst, wchar_t src)
 
 #endif
 
+#if HAVE_MBRTOWC && HAVE_WCRTOMB
+
+//
+// use C library reentrant multibyte conversion.  each conversion keeps
+// its own shift state so no lock is necessary.
+//
+
+typedef mbstate_t		CMBState;
+
+static inline
+void
+resetState(CMBState* state)
+{
+	memset(state, 0, sizeof(*state));
+}
+
+static inline
+int
+convCharWCToMB(char* dst, wchar_t src, CMBState* state)
+{
+	size_t mblen = wcrtomb(dst, src, state);
+	if (mblen == (size_t)-1) {
+		resetState(state);
+		return -1;
+	}
+	return (int)mblen;
+}
+
+static inline
+int
+convCharMBToWC(wchar_t* dst, const char* src, UInt32 n, CMBState* state)
+{
+	size_t mblen = mbrtowc(dst, src, n, state);
+	if (mblen == (size_t)-1 || mblen == (size_t)-2) {
+		resetState(state);
+		return (mblen == (size_t)-1) ? -1 : -2;
+	}
+	return (int)mblen;
+}
+
+#define LOCK_CONVERSION
+#define UNLOCK_CONVERSION
+
+#else
+
 //
 // use C library non-reentrant multibyte conversion with mutex
 //
 
+typedef int				CMBState;
+
 static CArchMutex		s_mutex = NULL;
 
+static inline
+void
+resetState(CMBState*)
+{
+	// do nothing
+}
+
+static inline
+int
+convCharWCToMB(char* dst, wchar_t src, CMBState*)
+{
+	return wctomb(dst, src);
+}
+
+static inline
+int
+convCharMBToWC(wchar_t* dst, const char* src, UInt32 n, CMBState*)
+{
+	return mbtowc(dst, src, n);
+}
+
+#define LOCK_CONVERSION		ARCH->lockMutex(s_mutex)
+#define UNLOCK_CONVERSION	ARCH->unlockMutex(s_mutex)
+
+#endif
+
+// true iff the locale's multibyte encoding is UTF-8
+static bool				s_utf8 = false;
+
+//
+// UTF-8 conversion.  used instead of the C library when the locale
+// uses UTF-8.  errors are handled the same way as the C library path.
+//
+
+static
+int
+convStringWCToUTF8(char* dst, const wchar_t* src, UInt32 n, bool* errors)
+{
+	int len = 0;
+	for (; n > 0; ++src, --n) {
+		UInt32 c = (UInt32)*src;
+		int mblen;
+		if (c < 0x80) {
+			mblen = 1;
+			if (dst != NULL) {
+				dst[0] = (char)c;
+			}
+		}
+		else if (c < 0x800) {
+			mblen = 2;
+			if (dst != NULL) {
+				dst[0] = (char)(0xc0 | (c >> 6));
+				dst[1] = (char)(0x80 | (c & 0x3f));
+			}
+		}
+		else if ((c >= 0xd800 && c <= 0xdfff) || c >= 0x110000) {
+			*errors = true;
+			mblen   = 1;
+			if (dst != NULL) {
+				dst[0] = '?';
+			}
+		}
+		else if (c < 0x10000) {
+			mblen = 3;
+			if (dst != NULL) {
+				dst[0] = (char)(0xe0 | (c >> 12));
+				dst[1] = (char)(0x80 | ((c >> 6) & 0x3f));
+				dst[2] = (char)(0x80 | (c & 0x3f));
+			}
+		}
+		else {
+			mblen = 4;
+			if (dst != NULL) {
+				dst[0] = (char)(0xf0 | (c >> 18));
+				dst[1] = (char)(0x80 | ((c >> 12) & 0x3f));
+				dst[2] = (char)(0x80 | ((c >> 6) & 0x3f));
+				dst[3] = (char)(0x80 | (c & 0x3f));
+			}
+		}
+		if (dst != NULL) {
+			dst += mblen;
+		}
+		len += mblen;
+	}
+	return len;
+}
+
+static
+int
+convCharUTF8ToWC(wchar_t* dst, const char* src, UInt32 n)
+{
+	// returns the number of bytes used, -1 if the character is invalid
+	// and -2 if it's incomplete, like mbrtowc().
+	const unsigned char* data = (const unsigned char*)src;
+	UInt32 c = data[0];
+	UInt32 size;
+	UInt32 min, max;
+	if (c < 0x80) {
+		*dst = (wchar_t)c;
+		return (c == 0) ? 0 : 1;
+	}
+	else if (c < 0xc2) {
+		return -1;
+	}
+	else if (c < 0xe0) {
+		size = 2;
+		c   &= 0x1f;
+		min  = 0x80;
+		max  = 0xbf;
+	}
+	else if (c < 0xf0) {
+		size = 3;
+		min  = (c == 0xe0) ? 0xa0 : 0x80;
+		max  = (c == 0xed) ? 0x9f : 0xbf;
+		c   &= 0x0f;
+	}
+	else if (c < 0xf5) {
+		size = 4;
+		min  = (c == 0xf0) ? 0x90 : 0x80;
+		max  = (c == 0xf4) ? 0x8f : 0xbf;
+		c   &= 0x07;
+	}
+	else {
+		return -1;
+	}
+
+	// the second byte has a restricted range to exclude overlong forms,
+	// surrogates and characters beyond U+10FFFF
+	for (UInt32 i = 1; i < size; ++i) {
+		if (i == n) {
+			return -2;
+		}
+		if (data[i] < min || data[i] > max) {
+			return -1;
+		}
+		c   = (c << 6) | (data[i] & 0x3f);
+		min = 0x80;
+		max = 0xbf;
+	}
+	*dst = (wchar_t)c;
+	return (int)size;
+}
+
 ARCH_STRING::ARCH_STRING()
 {
+#if HAVE_MBRTOWC && HAVE_WCRTOMB
+	CMBState state;
+	resetState(&state);
+#else
 	s_mutex = ARCH->newMutex();
+	CMBState state = 0;
+#endif
+	char mb[MB_LEN_MAX];
 
 #if HAVE_LOCALE_H
 	// see if we can convert a Latin-1 character
-	char mb[MB_LEN_MAX];
-	if (wctomb(mb, 0xe3) == -1) {
+	if (convCharWCToMB(mb, 0xe3, &state) == -1) {
 		// can't convert.  try another locale so we can convert latin-1.
 		setlocale(LC_CTYPE, "en_US");
 	}
 #endif
+
+	// see if the locale uses UTF-8.  wide characters must be UCS-4.
+	resetState(&state);
+	s_utf8 = (sizeof(wchar_t) >= 4 &&
+				convCharWCToMB(mb, 0x20ac, &state) == 3 &&
+				memcmp(mb, "\xe2\x82\xac", 3) == 0);
 }
 
 ARCH_STRING::~ARCH_STRING()
 {
+#if !(HAVE_MBRTOWC && HAVE_WCRTOMB)
 	ARCH->closeMutex(s_mutex);
 	s_mutex = NULL;
+#endif
 }
 
 int
@@ -87,18 +291,24 @@ ARCH_STRING::convStringWCToMB(char* dst,
 		errors = &dummyErrors;
 	}
 
-	ARCH->lockMutex(s_mutex);
+	if (s_utf8) {
+		return convStringWCToUTF8(dst, src, n, errors);
+	}
+
+	CMBState state;
+	resetState(&state);
+	LOCK_CONVERSION;
 	if (dst == NULL) {
 		char dummy[MB_LEN_MAX];
 		for (const wchar_t* scan = src; n > 0; ++scan, --n) {
-			int mblen = wctomb(dummy, *scan);
+			int mblen = convCharWCToMB(dummy, *scan, &state);
 			if (mblen == -1) {
 				*errors = true;
 				mblen   = 1;
 			}
 			len += mblen;
 		}
-		int mblen = wctomb(dummy, L'\0');
+		int mblen = convCharWCToMB(dummy, L'\0', &state);
 		if (mblen != -1) {
 			len += mblen - 1;
 		}
@@ -106,7 +316,7 @@ ARCH_STRING::convStringWCToMB(char* dst,
 	else {
 		char* dst0 = dst;
 		for (const wchar_t* scan = src; n > 0; ++scan, --n) {
-			int mblen = wctomb(dst, *scan);
+			int mblen = convCharWCToMB(dst, *scan, &state);
 			if (mblen == -1) {
 				*errors = true;
 				*dst++  = '?';
@@ -115,14 +325,14 @@ ARCH_STRING::convStringWCToMB(char* dst,
 				dst    += mblen;
 			}
 		}
-		int mblen = wctomb(dst, L'\0');
+		int mblen = convCharWCToMB(dst, L'\0', &state);
 		if (mblen != -1) {
 			// don't include nul terminator
 			dst += mblen - 1;
 		}
 		len = (int)(dst - dst0);
 	}
-	ARCH->unlockMutex(s_mutex);
+	UNLOCK_CONVERSION;
 
 	return len;
 }
@@ -139,10 +349,15 @@ ARCH_STRING::convStringMBToWC(wchar_t* dst,
 		errors = &dummyErrors;
 	}
 
-	ARCH->lockMutex(s_mutex);
+	CMBState state;
+	resetState(&state);
+	if (!s_utf8) {
+		LOCK_CONVERSION;
+	}
 	if (dst == NULL) {
 		for (const char* scan = src; n > 0; ) {
-			int mblen = mbtowc(&dummy, scan, n);
+			int mblen = s_utf8 ? convCharUTF8ToWC(&dummy, scan, n) :
+								convCharMBToWC(&dummy, scan, n, &state);
 			switch (mblen) {
 			case -2:
 				// incomplete last character.  convert to unknown character.
@@ -178,7 +393,8 @@ ARCH_STRING::convStringMBToWC(wchar_t* dst,
 	else {
 		wchar_t* dst0 = dst;
 		for (const char* scan = src; n > 0; ++dst) {
-			int mblen = mbtowc(dst, scan, n);
+			int mblen = s_utf8 ? convCharUTF8ToWC(dst, scan, n) :
+								convCharMBToWC(dst, scan, n, &state);
 			switch (mblen) {
 			case -2:
 				// incomplete character.  convert to unknown character.
@@ -211,7 +427,9 @@ ARCH_STRING::convStringMBToWC(wchar_t* dst,
 		}
 		len = (int)(dst - dst0);
 	}
-	ARCH->unlockMutex(s_mutex);
+	if (!s_utf8) {
+		UNLOCK_CONVERSION;
+	}
 
 	return len;
 }
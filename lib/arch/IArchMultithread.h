@@ -16,6 +16,7 @@
 #define IARCHMULTITHREAD_H
 
 #include "IInterface.h"
+#include "stdvector.h"
 
 /*!      
 \class CArchCondImpl
@@ -85,6 +86,12 @@ public:
 	};
 	//! Type of signal handler function
 	typedef void		(*SignalFunc)(ESignal, void* userData);
+	//! Thread scheduling policies
+	enum ESchedulingPolicy {
+		kSchedulingNormal,		//!< Time sharing
+		kSchedulingRoundRobin,	//!< Real-time, round robin
+		kSchedulingFIFO			//!< Real-time, first in first out
+	};
 
 	//! @name manipulators
 	//@{
@@ -198,6 +205,30 @@ public:
 	*/
 	virtual void		setPriorityOfThread(CArchThread, int n) = 0;
 
+	//! Set thread scheduling
+	/*!
+	Sets the scheduling policy of \c thread to \c policy.  For
+	\c kSchedulingNormal, \c priority is a nice value (lower is higher
+	priority) and some platforms can only set it for the calling
+	thread.  For the real-time policies it's the real-time priority
+	(higher is higher priority), clamped to the range the platform
+	allows.  Threads created afterwards by \c thread inherit its
+	scheduling where the platform allows.  Returns false, leaving the
+	scheduling unchanged, if not permitted or not supported.
+	*/
+	virtual bool		setSchedulingOfThread(CArchThread,
+							ESchedulingPolicy policy, int priority) = 0;
+
+	//! Set thread CPU affinity
+	/*!
+	Restricts \c thread to running on the CPUs numbered in \c cpus.
+	Threads created afterwards by \c thread inherit the affinity where
+	the platform allows.  Returns false, leaving the affinity
+	unchanged, if not permitted or not supported.
+	*/
+	virtual bool		setAffinityOfThread(CArchThread,
+							const std::vector<int>& cpus) = 0;
+
 	//! Cancellation point
 	/*!
 	This method does nothing but is a cancellation point.  Clients
@@ -243,13 +274,20 @@ public:
 
 	//! Returns an ID for a thread
 	/*!
-	Returns some ID number for \c thread.  This is for logging purposes.
-	All thread objects referring to the same thread return the same ID.
-	However, clients should us isSameThread() to compare thread objects
-	instead of comparing IDs.
+	Returns some ID number for \c thread.  All thread objects referring
+	to the same thread return the same ID and no two running threads
+	have the same ID, though the ID of an exited thread may be reused.
 	*/
 	virtual ThreadID	getIDOfThread(CArchThread thread) = 0;
 
+	//! Returns an ID for the calling thread
+	/*!
+	Returns getIDOfThread() for the calling thread without creating a
+	thread object.  This is cheap enough to track which thread owns
+	a resource.
+	*/
+	virtual ThreadID	getIDOfCurrentThread() = 0;
+
 	//! Set the interrupt handler
 	/*!
 	Sets the function to call on receipt of an external interrupt.
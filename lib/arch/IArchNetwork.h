@@ -98,6 +98,38 @@ public:
 		unsigned short	m_revents;
 	};
 
+	//! Kinds of socket errors
+	/*!
+	Each kind corresponds to the exception that the throwing form of
+	a method throws for the same error.
+	*/
+	enum ESocketError {
+		kSocketOK,				//!< No error
+		kSocketShutdown,		//!< XArchNetworkShutdown
+		kSocketDisconnected,	//!< XArchNetworkDisconnected
+		kSocketFailed			//!< Any other XArchNetwork
+	};
+
+	//! A socket error
+	/*!
+	The non-throwing forms of the socket methods report errors in this
+	instead of throwing.  They're meant for the socket multiplexer jobs,
+	where errors such as a peer disconnecting are routine.
+	*/
+	class CSocketError {
+	public:
+		CSocketError() : m_type(kSocketOK), m_error(0) { }
+
+		//! The kind of error
+		ESocketError	m_type;
+
+		//! The platform's error code
+		int				m_error;
+
+		//! The exception's what() for the error, empty if kSocketOK
+		std::string		m_what;
+	};
+
 	//! @name manipulators
 	//@{
 
@@ -157,6 +189,14 @@ public:
 	*/
 	virtual CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr) = 0;
 
+	//! Accept connection on socket without throwing
+	/*!
+	Same as acceptSocket() except errors are returned in \c error
+	instead of thrown.  Returns NULL on error.
+	*/
+	virtual CArchSocket	acceptSocket(CArchSocket s, CArchNetAddress* addr,
+							CSocketError* error) = 0;
+
 	//! Connect socket
 	/*!
 	Connects the socket \c s to the remote address \c addr.  Returns
@@ -185,6 +225,16 @@ public:
 	*/
 	virtual int			pollSocket(CPollEntry[], int num, double timeout) = 0;
 
+	//! Check socket state without throwing
+	/*!
+	Same as pollSocket() except errors are returned in \c error
+	instead of thrown.  Returns 0 on error.
+
+	(Cancellation point)
+	*/
+	virtual int			pollSocket(CPollEntry[], int num, double timeout,
+							CSocketError* error) = 0;
+
 	//! Unblock thread in pollSocket()
 	/*!
 	Cause a thread that's in a pollSocket() call to return.  This
@@ -212,6 +262,23 @@ public:
 	virtual size_t		writeSocket(CArchSocket s,
 							const void* buf, size_t len) = 0;
 
+	//! Read data from socket without throwing
+	/*!
+	Same as readSocket() except errors are returned in \c error
+	instead of thrown.  Returns 0 on error.
+	*/
+	virtual size_t		readSocket(CArchSocket s, void* buf, size_t len,
+							CSocketError* error) = 0;
+
+	//! Write data to socket without throwing
+	/*!
+	Same as writeSocket() except errors are returned in \c error
+	instead of thrown.  Returns 0 on error.
+	*/
+	virtual size_t		writeSocket(CArchSocket s,
+							const void* buf, size_t len,
+							CSocketError* error) = 0;
+
 	//! Check error on socket
 	/*!
 	If the socket \c s is in an error state then throws an appropriate
@@ -219,6 +286,14 @@ public:
 	*/
 	virtual void		throwErrorOnSocket(CArchSocket s) = 0;
 
+	//! Get error on socket
+	/*!
+	Same as throwErrorOnSocket() except the error is returned in
+	\c error instead of thrown.  Returns true iff there's an error.
+	*/
+	virtual bool		getErrorOnSocket(CArchSocket s,
+							CSocketError* error) = 0;
+
 	//! Turn Nagle algorithm on or off on socket
 	/*!
 	Set socket to send messages immediately (true) or to collect small
@@ -24,6 +24,17 @@ This interface defines operations for querying system info.
 */
 class IArchSystem : public IInterface {
 public:
+	//! @name manipulators
+	//@{
+
+	//! Lock memory
+	/*!
+	Locks the process's current and future memory into RAM so it's
+	never paged out.  Returns false if not permitted or not supported.
+	*/
+	virtual bool		lockMemory() = 0;
+
+	//@}
 	//! @name accessors
 	//@{
 
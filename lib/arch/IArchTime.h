@@ -30,10 +30,21 @@ public:
 	//! Get the current time
 	/*!
 	Returns the number of seconds since some arbitrary starting time.
-	This should return as high a precision as reasonable.
+	This should return as high a precision as reasonable.  The time
+	is monotonic:  it never goes backwards and doesn't jump when the
+	system clock is set.  It is not the time of day.
 	*/
 	virtual double		time() = 0;
 
+	//! Get the current time cheaply
+	/*!
+	Returns the time() but possibly several milliseconds stale.  On
+	some platforms this is much cheaper than time().  Use it for
+	timeouts and bookkeeping that don't need better than about 10ms
+	precision.
+	*/
+	virtual double		coarseTime() = 0;
+
 	//@}
 };
 
@@ -22,7 +22,7 @@
 // interrupt handler.  this just adds a quit event to the queue.
 static
 void
-interrupt(CArch::ESignal, void*)
+interrupt(IArchMultithread::ESignal, void*)
 {
 	EVENTQUEUE->addEvent(CEvent(CEvent::kQuit));
 }
@@ -37,16 +37,16 @@ CEventQueue::CEventQueue() :
 {
 	setInstance(this);
 	m_mutex = ARCH->newMutex();
-	ARCH->setSignalHandler(CArch::kINTERRUPT, &interrupt, NULL);
-	ARCH->setSignalHandler(CArch::kTERMINATE, &interrupt, NULL);
+	ARCH->setSignalHandler(IArchMultithread::kINTERRUPT, &interrupt, NULL);
+	ARCH->setSignalHandler(IArchMultithread::kTERMINATE, &interrupt, NULL);
 	m_buffer = new CSimpleEventQueueBuffer;
 }
 
 CEventQueue::~CEventQueue()
 {
 	delete m_buffer;
-	ARCH->setSignalHandler(CArch::kINTERRUPT, NULL, NULL);
-	ARCH->setSignalHandler(CArch::kTERMINATE, NULL, NULL);
+	ARCH->setSignalHandler(IArchMultithread::kINTERRUPT, NULL, NULL);
+	ARCH->setSignalHandler(IArchMultithread::kTERMINATE, NULL, NULL);
 	ARCH->closeMutex(m_mutex);
 	setInstance(NULL);
 }
@@ -0,0 +1,180 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "CSharedString.h"
+#include <string.h>
+
+//
+// CSharedString
+//
+
+// 64-bit FNV-1a offset basis and prime.  these are built from 32-bit
+// halves because not every compiler we support accepts 64-bit literals.
+const CSharedString::Hash	CSharedString::kHashInit =
+	(static_cast<CSharedString::Hash>(0xcbf29ce4u) << 32) | 0x84222325u;
+static const CSharedString::Hash	s_hashPrime =
+	(static_cast<CSharedString::Hash>(0x00000100u) << 32) | 0x000001b3u;
+
+CSharedString::CSharedString() :
+	m_rep(NULL)
+{
+	// do nothing
+}
+
+CSharedString::CSharedString(const CString& data) :
+	m_rep(NULL)
+{
+	if (!data.empty()) {
+		m_rep         = new CRep;
+		m_rep->m_data = data;
+	}
+}
+
+CSharedString::CSharedString(const char* data, UInt32 n) :
+	m_rep(NULL)
+{
+	if (n > 0) {
+		m_rep = new CRep;
+		m_rep->m_data.assign(data, n);
+	}
+}
+
+CSharedString::CSharedString(const CSharedString& src) :
+	m_rep(src.m_rep)
+{
+	if (m_rep != NULL) {
+		++m_rep->m_refCount;
+	}
+}
+
+CSharedString::~CSharedString()
+{
+	release();
+}
+
+CSharedString&
+CSharedString::operator=(const CSharedString& src)
+{
+	if (src.m_rep != m_rep) {
+		if (src.m_rep != NULL) {
+			++src.m_rep->m_refCount;
+		}
+		release();
+		m_rep = src.m_rep;
+	}
+	return *this;
+}
+
+void
+CSharedString::adopt(CString& data)
+{
+	release();
+	if (!data.empty()) {
+		m_rep = new CRep;
+		m_rep->m_data.swap(data);
+	}
+}
+
+const char*
+CSharedString::data() const
+{
+	return (m_rep == NULL) ? "" : m_rep->m_data.data();
+}
+
+UInt32
+CSharedString::size() const
+{
+	return (m_rep == NULL) ? 0 : static_cast<UInt32>(m_rep->m_data.size());
+}
+
+bool
+CSharedString::empty() const
+{
+	return (m_rep == NULL);
+}
+
+const CString&
+CSharedString::str() const
+{
+	static const CString s_empty;
+	return (m_rep == NULL) ? s_empty : m_rep->m_data;
+}
+
+CSharedString::Hash
+CSharedString::getHash() const
+{
+	if (m_rep == NULL) {
+		return kHashInit;
+	}
+	if (!m_rep->m_hashed) {
+		m_rep->m_hash   = hash(m_rep->m_data.data(),
+							static_cast<UInt32>(m_rep->m_data.size()),
+							kHashInit);
+		m_rep->m_hashed = true;
+	}
+	return m_rep->m_hash;
+}
+
+bool
+CSharedString::operator==(const CSharedString& x) const
+{
+	if (m_rep == x.m_rep) {
+		return true;
+	}
+	if (size() != x.size() || getHash() != x.getHash()) {
+		return false;
+	}
+	return (memcmp(data(), x.data(), size()) == 0);
+}
+
+bool
+CSharedString::operator!=(const CSharedString& x) const
+{
+	return !operator==(x);
+}
+
+CSharedString::Hash
+CSharedString::hash(const void* data, UInt32 n, Hash hash)
+{
+	const UInt8* scan = reinterpret_cast<const UInt8*>(data);
+	const UInt8* end  = scan + n;
+	while (scan != end) {
+		hash ^= *scan++;
+		hash *= s_hashPrime;
+	}
+	return hash;
+}
+
+void
+CSharedString::release()
+{
+	if (m_rep != NULL && --m_rep->m_refCount == 0) {
+		delete m_rep;
+	}
+	m_rep = NULL;
+}
+
+
+//
+// CSharedString::CRep
+//
+
+CSharedString::CRep::CRep() :
+	m_data(),
+	m_hash(0),
+	m_hashed(false),
+	m_refCount(1)
+{
+	// do nothing
+}
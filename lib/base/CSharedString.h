@@ -0,0 +1,136 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef CSHAREDSTRING_H
+#define CSHAREDSTRING_H
+
+#include "CString.h"
+#include "BasicTypes.h"
+
+//! Reference counted immutable string
+/*!
+This class holds an immutable sequence of bytes.  Copying a
+CSharedString only copies a reference to the bytes so any number of
+holders can share a single copy of (potentially large) data, such as
+clipboard contents.  A 64-bit hash of the content is computed on first
+use and cached with the data so comparing two shared strings is
+usually just a comparison of sizes and hashes.
+
+The reference count is not protected by a lock.  Objects sharing data
+must only be used by one thread at a time.
+*/
+class CSharedString {
+public:
+	//! Hash type
+	typedef UInt64		Hash;
+
+	//! Create an empty string
+	CSharedString();
+	//! Create a string holding a copy of \p data
+	explicit CSharedString(const CString& data);
+	//! Create a string holding a copy of \p n bytes at \p data
+	CSharedString(const char* data, UInt32 n);
+	CSharedString(const CSharedString&);
+	~CSharedString();
+
+	//! @name manipulators
+	//@{
+
+	//! Assign
+	CSharedString&		operator=(const CSharedString&);
+
+	//! Take ownership of a string
+	/*!
+	Replaces the contents of this object with the contents of \p data
+	without copying the bytes.  \p data is left empty.
+	*/
+	void				adopt(CString& data);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get the bytes
+	/*!
+	Returns a pointer to the bytes.  The pointer is valid as long as
+	some CSharedString refers to the data.
+	*/
+	const char*			data() const;
+
+	//! Get the number of bytes
+	UInt32				size() const;
+
+	//! Test for emptiness
+	bool				empty() const;
+
+	//! Get the data as a string
+	/*!
+	Returns a reference to the data as a CString.  Callers that need a
+	modifiable string must copy it.
+	*/
+	const CString&		str() const;
+
+	//! Get the content hash
+	/*!
+	Returns the 64-bit hash of the data, computing it if necessary.
+	Equal data always has equal hashes.
+	*/
+	Hash				getHash() const;
+
+	//! Compare contents
+	/*!
+	Returns true iff both strings hold the same bytes.  Strings that
+	share data compare equal immediately, otherwise the sizes and
+	hashes are compared and only on a hash match are the bytes
+	compared.
+	*/
+	bool				operator==(const CSharedString&) const;
+	//! Compare contents
+	bool				operator!=(const CSharedString&) const;
+
+	//! Hash bytes
+	/*!
+	Updates the hash \p hash with \p n bytes at \p data and returns
+	the new hash.  Data can be hashed incrementally by passing the
+	result of one call to the next;  the first call should use
+	\c kHashInit.  The result is the same no matter how the data is
+	split between calls.
+	*/
+	static Hash			hash(const void* data, UInt32 n, Hash hash);
+
+	//! Initial hash value
+	static const Hash	kHashInit;
+
+	//@}
+
+private:
+	class CRep {
+	public:
+		CRep();
+
+	public:
+		CString			m_data;
+		mutable Hash	m_hash;
+		mutable bool	m_hashed;
+		SInt32			m_refCount;
+	};
+
+	void				release();
+
+private:
+	// NULL if empty
+	CRep*				m_rep;
+};
+
+#endif
@@ -25,7 +25,7 @@ CStopwatch::CStopwatch(bool triggered) :
 	m_stopped(triggered)
 {
 	if (!triggered) {
-		m_mark = ARCH->time();
+		m_mark = ARCH->coarseTime();
 	}
 }
 
@@ -43,7 +43,7 @@ CStopwatch::reset()
 		return dt;
 	}
 	else {
-		const double t	= ARCH->time();
+		const double t	= ARCH->coarseTime();
 		const double dt = t - m_mark;
 		m_mark = t;
 		return dt;
@@ -58,7 +58,7 @@ CStopwatch::stop()
 	}
 
 	// save the elapsed time
-	m_mark	  = ARCH->time() - m_mark;
+	m_mark	  = ARCH->coarseTime() - m_mark;
 	m_stopped = true;
 }
 
@@ -71,7 +71,7 @@ CStopwatch::start()
 	}
 
 	// set the mark such that it reports the time elapsed at stop()
-	m_mark	  = ARCH->time() - m_mark;
+	m_mark	  = ARCH->coarseTime() - m_mark;
 	m_stopped = false;
 }
 
@@ -94,7 +94,7 @@ CStopwatch::getTime()
 		return m_mark;
 	}
 	else {
-		return ARCH->time() - m_mark;
+		return ARCH->coarseTime() - m_mark;
 	}
 }
 
@@ -116,7 +116,7 @@ CStopwatch::getTime() const
 		return m_mark;
 	}
 	else {
-		return ARCH->time() - m_mark;
+		return ARCH->coarseTime() - m_mark;
 	}
 }
 
@@ -20,7 +20,10 @@
 //! A timer class
 /*!
 This class measures time intervals.  All time interval measurement
-should use this class.
+should use this class.  It reads the coarse clock (see
+IArchTime::coarseTime()), which is good to about 10ms.  That's plenty
+for timers and timeouts;  latency measurements that need better use
+ARCH->time() directly.
 */
 class CStopwatch {
 public:
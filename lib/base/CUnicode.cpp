@@ -64,6 +64,79 @@ decode32(const UInt8* n, bool byteSwapped)
 	return c.n32;
 }
 
+inline
+static
+void
+encode16(UInt8*& dst, UInt16 c)
+{
+	memcpy(dst, &c, 2);
+	dst += 2;
+}
+
+inline
+static
+void
+encode32(UInt8*& dst, UInt32 c)
+{
+	memcpy(dst, &c, 4);
+	dst += 4;
+}
+
+// the high bit of each byte in a 64-bit word.  built from 32-bit halves
+// because not every compiler we support accepts 64-bit literals.
+static const UInt64		s_highBits =
+	(static_cast<UInt64>(0x80808080u) << 32) | 0x80808080u;
+
+inline
+static
+UInt32
+countASCII(const UInt8* data, UInt32 n)
+{
+	// check eight bytes at a time then finish byte by byte
+	UInt32 i = 0;
+	for (; n - i >= 8; i += 8) {
+		UInt64 word;
+		memcpy(&word, data + i, 8);
+		if ((word & s_highBits) != 0) {
+			break;
+		}
+	}
+	while (i < n && data[i] < 0x80) {
+		++i;
+	}
+	return i;
+}
+
+inline
+static
+UInt32
+getUTF8Size(UInt32 c)
+{
+	// number of bytes CUnicode::toUTF8() writes for c.  characters it
+	// can't encode are written as the 3 byte replacement character.
+	if (c < 0x00000080) {
+		return 1;
+	}
+	else if (c < 0x00000800) {
+		return 2;
+	}
+	else if (c < 0x00010000) {
+		return 3;
+	}
+	else if (c < 0x00200000) {
+		return 4;
+	}
+	else if (c < 0x04000000) {
+		return 5;
+	}
+	else if (c < 0x80000000) {
+		return 6;
+	}
+	else {
+		return 3;
+	}
+}
+
 inline
 static
 void
@@ -95,10 +168,15 @@ UInt32					CUnicode::s_replacement = 0x0000fffd;
 bool
 CUnicode::isUTF8(const CString& src)
 {
-	// convert and test each character
+	// convert and test each character, skipping over runs of ASCII
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	for (UInt32 n = src.size(); n > 0; ) {
-		if (fromUTF8(data, n) == s_invalid) {
+		if (*data < 0x80) {
+			UInt32 m = countASCII(data, n);
+			data    += m;
+			n       -= m;
+		}
+		else if (fromUTF8(data, n) == s_invalid) {
 			return false;
 		}
 	}
@@ -111,14 +189,26 @@ CUnicode::UTF8ToUCS2(const CString& src, bool* errors)
 	// default to success
 	resetError(errors);
 
-	// get size of input string and reserve some space in output
+	// get size of input string.  each input byte yields at most one
+	// character so size the output for that and trim it afterwards.
 	UInt32 n = src.size();
-	CString dst;
-	dst.reserve(2 * n);
+	if (n == 0) {
+		return CString();
+	}
+	CString dst(2 * n, '\0');
+	UInt8* out = reinterpret_cast<UInt8*>(&dst[0]);
 
 	// convert each character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	while (n > 0) {
+		// widen runs of ASCII directly
+		if (*data < 0x80) {
+			for (UInt32 m = countASCII(data, n); m > 0; --m, --n) {
+				encode16(out, static_cast<UInt16>(*data++));
+			}
+			continue;
+		}
+
 		UInt32 c = fromUTF8(data, n);
 		if (c == s_invalid) {
 			c = s_replacement;
@@ -127,10 +217,10 @@ CUnicode::UTF8ToUCS2(const CString& src, bool* errors)
 			setError(errors);
 			c = s_replacement;
 		}
-		UInt16 ucs2 = static_cast<UInt16>(c);
-		dst.append(reinterpret_cast<const char*>(&ucs2), 2);
+		encode16(out, static_cast<UInt16>(c));
 	}
 
+	dst.resize(out - reinterpret_cast<UInt8*>(&dst[0]));
 	return dst;
 }
 
@@ -140,21 +230,34 @@ CUnicode::UTF8ToUCS4(const CString& src, bool* errors)
 	// default to success
 	resetError(errors);
 
-	// get size of input string and reserve some space in output
+	// get size of input string.  each input byte yields at most one
+	// character so size the output for that and trim it afterwards.
 	UInt32 n = src.size();
-	CString dst;
-	dst.reserve(4 * n);
+	if (n == 0) {
+		return CString();
+	}
+	CString dst(4 * n, '\0');
+	UInt8* out = reinterpret_cast<UInt8*>(&dst[0]);
 
 	// convert each character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	while (n > 0) {
+		// widen runs of ASCII directly
+		if (*data < 0x80) {
+			for (UInt32 m = countASCII(data, n); m > 0; --m, --n) {
+				encode32(out, static_cast<UInt32>(*data++));
+			}
+			continue;
+		}
+
 		UInt32 c = fromUTF8(data, n);
 		if (c == s_invalid) {
 			c = s_replacement;
 		}
-		dst.append(reinterpret_cast<const char*>(&c), 4);
+		encode32(out, c);
 	}
 
+	dst.resize(out - reinterpret_cast<UInt8*>(&dst[0]));
 	return dst;
 }
 
@@ -164,14 +267,27 @@ CUnicode::UTF8ToUTF16(const CString& src, bool* errors)
 	// default to success
 	resetError(errors);
 
-	// get size of input string and reserve some space in output
+	// get size of input string.  surrogate pairs come from sequences of
+	// at least four bytes so the output is at most two bytes per input
+	// byte.  size the output for that and trim it afterwards.
 	UInt32 n = src.size();
-	CString dst;
-	dst.reserve(2 * n);
+	if (n == 0) {
+		return CString();
+	}
+	CString dst(2 * n, '\0');
+	UInt8* out = reinterpret_cast<UInt8*>(&dst[0]);
 
 	// convert each character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	while (n > 0) {
+		// widen runs of ASCII directly
+		if (*data < 0x80) {
+			for (UInt32 m = countASCII(data, n); m > 0; --m, --n) {
+				encode16(out, static_cast<UInt16>(*data++));
+			}
+			continue;
+		}
+
 		UInt32 c = fromUTF8(data, n);
 		if (c == s_invalid) {
 			c = s_replacement;
@@ -181,18 +297,16 @@ CUnicode::UTF8ToUTF16(const CString& src, bool* errors)
 			c = s_replacement;
 		}
 		if (c < 0x00010000) {
-			UInt16 ucs2 = static_cast<UInt16>(c);
-			dst.append(reinterpret_cast<const char*>(&ucs2), 2);
+			encode16(out, static_cast<UInt16>(c));
 		}
 		else {
 			c -= 0x00010000;
-			UInt16 utf16h = static_cast<UInt16>((c >> 10) + 0xd800);
-			UInt16 utf16l = static_cast<UInt16>((c & 0x03ff) + 0xdc00);
-			dst.append(reinterpret_cast<const char*>(&utf16h), 2);
-			dst.append(reinterpret_cast<const char*>(&utf16l), 2);
+			encode16(out, static_cast<UInt16>((c >> 10) + 0xd800));
+			encode16(out, static_cast<UInt16>((c & 0x03ff) + 0xdc00));
 		}
 	}
 
+	dst.resize(out - reinterpret_cast<UInt8*>(&dst[0]));
 	return dst;
 }
 
@@ -202,14 +316,26 @@ CUnicode::UTF8ToUTF32(const CString& src, bool* errors)
 	// default to success
 	resetError(errors);
 
-	// get size of input string and reserve some space in output
+	// get size of input string.  each input byte yields at most one
+	// character so size the output for that and trim it afterwards.
 	UInt32 n = src.size();
-	CString dst;
-	dst.reserve(4 * n);
+	if (n == 0) {
+		return CString();
+	}
+	CString dst(4 * n, '\0');
+	UInt8* out = reinterpret_cast<UInt8*>(&dst[0]);
 
 	// convert each character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	while (n > 0) {
+		// widen runs of ASCII directly
+		if (*data < 0x80) {
+			for (UInt32 m = countASCII(data, n); m > 0; --m, --n) {
+				encode32(out, static_cast<UInt32>(*data++));
+			}
+			continue;
+		}
+
 		UInt32 c = fromUTF8(data, n);
 		if (c == s_invalid) {
 			c = s_replacement;
@@ -218,9 +344,10 @@ CUnicode::UTF8ToUTF32(const CString& src, bool* errors)
 			setError(errors);
 			c = s_replacement;
 		}
-		dst.append(reinterpret_cast<const char*>(&c), 4);
+		encode32(out, c);
 	}
 
+	dst.resize(out - reinterpret_cast<UInt8*>(&dst[0]));
 	return dst;
 }
 
@@ -376,10 +503,6 @@ CUnicode::wideCharToUTF8(const wchar_t* src, UInt32 size, bool* errors)
 CString
 CUnicode::doUCS2ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 {
-	// make some space
-	CString dst;
-	dst.reserve(n);
-
 	// check if first character is 0xfffe or 0xfeff
 	bool byteSwapped = false;
 	if (n >= 1) {
@@ -400,10 +523,23 @@ CUnicode::doUCS2ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 		}
 	}
 
+	// size the output exactly
+	UInt32 size = 0;
+	for (UInt32 i = 0; i < n; ++i) {
+		size += getUTF8Size(decode16(data + 2 * i, byteSwapped));
+	}
+	CString dst;
+	dst.reserve(size);
+
 	// convert each character
 	for (; n > 0; data += 2, --n) {
 		UInt32 c = decode16(data, byteSwapped);
-		toUTF8(dst, c, errors);
+		if (c < 0x00000080) {
+			dst += static_cast<char>(c);
+		}
+		else {
+			toUTF8(dst, c, errors);
+		}
 	}
 
 	return dst;
@@ -412,10 +548,6 @@ CUnicode::doUCS2ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 CString
 CUnicode::doUCS4ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 {
-	// make some space
-	CString dst;
-	dst.reserve(n);
-
 	// check if first character is 0xfffe or 0xfeff
 	bool byteSwapped = false;
 	if (n >= 1) {
@@ -436,10 +568,23 @@ CUnicode::doUCS4ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 		}
 	}
 
+	// size the output exactly
+	UInt32 size = 0;
+	for (UInt32 i = 0; i < n; ++i) {
+		size += getUTF8Size(decode32(data + 4 * i, byteSwapped));
+	}
+	CString dst;
+	dst.reserve(size);
+
 	// convert each character
 	for (; n > 0; data += 4, --n) {
 		UInt32 c = decode32(data, byteSwapped);
-		toUTF8(dst, c, errors);
+		if (c < 0x00000080) {
+			dst += static_cast<char>(c);
+		}
+		else {
+			toUTF8(dst, c, errors);
+		}
 	}
 
 	return dst;
@@ -448,10 +593,6 @@ CUnicode::doUCS4ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 CString
 CUnicode::doUTF16ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 {
-	// make some space
-	CString dst;
-	dst.reserve(n);
-
 	// check if first character is 0xfffe or 0xfeff
 	bool byteSwapped = false;
 	if (n >= 1) {
@@ -472,10 +613,23 @@ CUnicode::doUTF16ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 		}
 	}
 
+	// size the output.  this counts each half of a surrogate pair as
+	// a replacement character so it's exact except for valid pairs,
+	// where it's two bytes too large.
+	UInt32 size = 0;
+	for (UInt32 i = 0; i < n; ++i) {
+		size += getUTF8Size(decode16(data + 2 * i, byteSwapped));
+	}
+	CString dst;
+	dst.reserve(size);
+
 	// convert each character
 	for (; n > 0; data += 2, --n) {
 		UInt32 c = decode16(data, byteSwapped);
-		if (c < 0x0000d800 || c > 0x0000dfff) {
+		if (c < 0x00000080) {
+			dst += static_cast<char>(c);
+		}
+		else if (c < 0x0000d800 || c > 0x0000dfff) {
 			toUTF8(dst, c, errors);
 		}
 		else if (n == 1) {
@@ -510,10 +664,6 @@ CUnicode::doUTF16ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 CString
 CUnicode::doUTF32ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 {
-	// make some space
-	CString dst;
-	dst.reserve(n);
-
 	// check if first character is 0xfffe or 0xfeff
 	bool byteSwapped = false;
 	if (n >= 1) {
@@ -534,6 +684,15 @@ CUnicode::doUTF32ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 		}
 	}
 
+	// size the output exactly
+	UInt32 size = 0;
+	for (UInt32 i = 0; i < n; ++i) {
+		UInt32 c = decode32(data + 4 * i, byteSwapped);
+		size    += (c >= 0x00110000) ? 3 : getUTF8Size(c);
+	}
+	CString dst;
+	dst.reserve(size);
+
 	// convert each character
 	for (; n > 0; data += 4, --n) {
 		UInt32 c = decode32(data, byteSwapped);
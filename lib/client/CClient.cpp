@@ -17,6 +17,7 @@
 #include "CScreen.h"
 #include "CClipboard.h"
 #include "CPacketStreamFilter.h"
+#include "CPriorityStreamFilter.h"
 #include "CProtocolUtil.h"
 #include "ProtocolTypes.h"
 #include "XSynergy.h"
@@ -103,12 +104,14 @@ CClient::connect()
 		// create the socket
 		IDataSocket* socket = m_socketFactory->create();
 
-		// filter socket messages, including a packetizing filter
+		// filter socket messages, including a packetizing filter and
+		// a filter to keep bulk data from delaying input events
 		m_stream = socket;
 		if (m_streamFilterFactory != NULL) {
 			m_stream = m_streamFilterFactory->create(m_stream, true);
 		}
 		m_stream = new CPacketStreamFilter(m_stream, true);
+		m_stream = new CPriorityStreamFilter(m_stream, true);
 
 		// connect
 		LOG((CLOG_DEBUG1 "connecting to server"));
@@ -190,6 +193,13 @@ CClient::getDisconnectedEvent()
 							"CClient::disconnected");
 }
 
+bool
+CClient::getClipboardFormats(ClipboardID id,
+				IClipboard* clipboard, UInt32 formats) const
+{
+	return m_screen->getClipboardFormats(id, clipboard, formats);
+}
+
 void*
 CClient::getEventTarget() const
 {
@@ -344,12 +354,19 @@ CClient::sendClipboard(ClipboardID id)
 	// get clipboard data.  set the clipboard time to the last
 	// clipboard time before getting the data from the screen
 	// as the screen may detect an unchanged clipboard and
-	// avoid copying the data.
+	// avoid copying the data.  a server that takes offers gets just
+	// the list of formats so nothing is converted until it asks for
+	// a format.
 	CClipboard clipboard;
 	if (clipboard.open(m_timeClipboard[id])) {
 		clipboard.close();
 	}
-	m_screen->getClipboard(id, &clipboard);
+	if (m_server->hasClipboardOffers()) {
+		m_screen->getClipboardFormats(id, &clipboard, 0);
+	}
+	else {
+		m_screen->getClipboard(id, &clipboard);
+	}
 
 	// check time
 	if (m_timeClipboard[id] == 0 ||
@@ -357,13 +374,15 @@ CClient::sendClipboard(ClipboardID id)
 		// save new time
 		m_timeClipboard[id] = clipboard.getTime();
 
-		// marshall the data
-		CString data = clipboard.marshall();
+		// hash the data
+		CSharedString::Hash hash = clipboard.getHash();
 
-		// save and send data if different or not yet sent
-		if (!m_sentClipboard[id] || data != m_dataClipboard[id]) {
+		// save and send data if different or not yet sent.  formats
+		// without their data can't be compared so always send those.
+		if (!m_sentClipboard[id] || hash != m_hashClipboard[id] ||
+			IClipboard::hasDeferred(&clipboard)) {
 			m_sentClipboard[id] = true;
-			m_dataClipboard[id] = data;
+			m_hashClipboard[id] = hash;
 			m_server->onClipboardChanged(id, &clipboard);
 		}
 	}
@@ -427,12 +446,12 @@ CClient::setupConnection()
 }
 
 void
-CClient::setupScreen()
+CClient::setupScreen(SInt16 minorVersion)
 {
 	assert(m_server == NULL);
 
 	m_ready  = false;
-	m_server = new CServerProxy(this, m_stream);
+	m_server = new CServerProxy(this, m_stream, minorVersion);
 	EVENTQUEUE->adoptHandler(IScreen::getShapeChangedEvent(),
 							getEventTarget(),
 							new TMethodEventJob<CClient>(this,
@@ -441,6 +460,10 @@ CClient::setupScreen()
 							getEventTarget(),
 							new TMethodEventJob<CClient>(this,
 								&CClient::handleClipboardGrabbed));
+	EVENTQUEUE->adoptHandler(IScreen::getClipboardRequestedEvent(),
+							getEventTarget(),
+							new TMethodEventJob<CClient>(this,
+								&CClient::handleClipboardRequested));
 }
 
 void
@@ -496,6 +519,8 @@ CClient::cleanupScreen()
 							getEventTarget());
 		EVENTQUEUE->removeHandler(IScreen::getClipboardGrabbedEvent(),
 							getEventTarget());
+		EVENTQUEUE->removeHandler(IScreen::getClipboardRequestedEvent(),
+							getEventTarget());
 		delete m_server;
 		m_server = NULL;
 	}
@@ -600,6 +625,16 @@ CClient::handleClipboardGrabbed(const CEvent& event, void*)
 	}
 }
 
+void
+CClient::handleClipboardRequested(const CEvent& event, void*)
+{
+	const IScreen::CClipboardInfo* info =
+		reinterpret_cast<const IScreen::CClipboardInfo*>(event.getData());
+
+	// get the deferred clipboard data from the server
+	m_server->onClipboardRequested(info->m_id);
+}
+
 void
 CClient::handleHello(const CEvent&, void*)
 {
@@ -614,21 +649,28 @@ CClient::handleHello(const CEvent&, void*)
 	// check versions
 	LOG((CLOG_DEBUG1 "got hello version %d.%d", major, minor));
 	if (major < kProtocolMajorVersion ||
-		(major == kProtocolMajorVersion && minor < kProtocolMinorVersion)) {
+		(major == kProtocolMajorVersion &&
+			minor < kProtocolMinimumMinorVersion)) {
 		sendConnectionFailedEvent(XIncompatibleClient(major, minor).what());
 		cleanupTimer();
 		cleanupConnection();
 		return;
 	}
 
+	// speak the older of the server's protocol and ours.  the server
+	// picks a proxy based on the version we say hello with.
+	if (major > kProtocolMajorVersion || minor > kProtocolMinorVersion) {
+		minor = kProtocolMinorVersion;
+	}
+
 	// say hello back
-	LOG((CLOG_DEBUG1 "say hello version %d.%d", kProtocolMajorVersion, kProtocolMinorVersion));
+	LOG((CLOG_DEBUG1 "say hello version %d.%d", kProtocolMajorVersion, minor));
 	CProtocolUtil::writef(m_stream, kMsgHelloBack,
 							kProtocolMajorVersion,
-							kProtocolMinorVersion, &m_name);
+							minor, &m_name);
 
 	// now connected but waiting to complete handshake
-	setupScreen();
+	setupScreen(minor);
 	cleanupTimer();
 
 	// make sure we process any remaining messages later.  we won't
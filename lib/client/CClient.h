@@ -118,6 +118,15 @@ public:
 	*/
 	static CEvent::Type	getDisconnectedEvent();
 
+	//! Get some clipboard formats
+	/*!
+	Like getClipboard() except only formats whose bit (1 << format) is
+	set in \c formats need be converted.  Other available formats may
+	be added as deferred.
+	*/
+	bool				getClipboardFormats(ClipboardID, IClipboard*,
+							UInt32 formats) const;
+
 	//@}
 
 	// IScreen overrides
@@ -155,7 +164,7 @@ private:
 	void				sendConnectionFailedEvent(const char* msg);
 	void				setupConnecting();
 	void				setupConnection();
-	void				setupScreen();
+	void				setupScreen(SInt16 minorVersion);
 	void				setupTimer();
 	void				cleanupConnecting();
 	void				cleanupConnection();
@@ -168,6 +177,7 @@ private:
 	void				handleDisconnected(const CEvent&, void*);
 	void				handleShapeChanged(const CEvent&, void*);
 	void				handleClipboardGrabbed(const CEvent&, void*);
+	void				handleClipboardRequested(const CEvent&, void*);
 	void				handleHello(const CEvent&, void*);
 	void				handleSuspend(const CEvent& event, void*);
 	void				handleResume(const CEvent& event, void*);
@@ -188,7 +198,7 @@ private:
 	bool				m_ownClipboard[kClipboardEnd];
 	bool				m_sentClipboard[kClipboardEnd];
 	IClipboard::Time	m_timeClipboard[kClipboardEnd];
-	CString				m_dataClipboard[kClipboardEnd];
+	CSharedString::Hash	m_hashClipboard[kClipboardEnd];
 
 	static CEvent::Type	s_connectedEvent;
 	static CEvent::Type	s_connectionFailedEvent;
@@ -29,10 +29,14 @@
 // CServerProxy
 //
 
-CServerProxy::CServerProxy(CClient* client, IStream* stream) :
+CServerProxy::CServerProxy(CClient* client, IStream* stream,
+				SInt16 minorVersion) :
 	m_client(client),
 	m_stream(stream),
+	m_minorVersion(minorVersion),
 	m_seqNum(0),
+	m_clipboardCache(kClipboardCacheEntries, kClipboardCacheSize),
+	m_clipboardTransfer(stream),
 	m_compressMouse(false),
 	m_compressMouseRelative(false),
 	m_xMouse(0),
@@ -51,6 +55,10 @@ CServerProxy::CServerProxy(CClient* client, IStream* stream) :
 	for (KeyModifierID id = 0; id < kKeyModifierIDLast; ++id)
 		m_modifierTranslationTable[id] = id;
 
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		m_recvQueried[id] = false;
+	}
+
 	// handle data on stream
 	EVENTQUEUE->adoptHandler(IStream::getInputReadyEvent(),
 							m_stream->getEventTarget(),
@@ -274,6 +282,21 @@ CServerProxy::parseMessage(const UInt8* code)
 		setClipboard();
 	}
 
+	else if (memcmp(code, kMsgDClipboardOffer, 4) == 0 &&
+				m_minorVersion >= 4) {
+		setClipboardOffer();
+	}
+
+	else if (memcmp(code, kMsgDClipboardFormats, 4) == 0 &&
+				m_minorVersion >= 4) {
+		setClipboardFormats();
+	}
+
+	else if (memcmp(code, kMsgQClipboard, 4) == 0 &&
+				m_minorVersion >= 4) {
+		queryClipboard();
+	}
+
 	else if (memcmp(code, kMsgCResetOptions, 4) == 0) {
 		resetOptions();
 	}
@@ -332,12 +355,32 @@ CServerProxy::onGrabClipboard(ClipboardID id)
 {
 	LOG((CLOG_DEBUG1 "sending clipboard %d changed", id));
 	CProtocolUtil::writef(m_stream, kMsgCClipboard, id, m_seqNum);
+
+	// any clipboard data we're still sending is out of date
+	m_clipboardTransfer.cancel(id);
+
+	// so is the server's offer.  forget it so formats still in flight
+	// don't take the clipboard back from the local owner.
+	m_recvOffer[id].clear();
+	m_recvQueried[id] = false;
 	return true;
 }
 
 void
 CServerProxy::onClipboardChanged(ClipboardID id, const IClipboard* clipboard)
 {
+	if (m_minorVersion >= 4) {
+		// offer the clipboard.  the server asks for what it doesn't
+		// already have.
+		m_clipboardTransfer.cancel(id);
+		m_sentOffer[id].set(clipboard, m_clipboardCache);
+		CString offer = m_sentOffer[id].marshall();
+		LOG((CLOG_DEBUG1 "sending clipboard %d offer seqnum=%d", id, m_seqNum));
+		CProtocolUtil::writef(m_stream, kMsgDClipboardOffer,
+							id, m_seqNum, &offer);
+		return;
+	}
+
 	CString data = IClipboard::marshall(clipboard);
 	LOG((CLOG_DEBUG1 "sending clipboard %d seqnum=%d, size=%d", id, m_seqNum, data.size()));
 	CProtocolUtil::writef(m_stream, kMsgDClipboard, id, m_seqNum, &data);
@@ -532,6 +575,155 @@ CServerProxy::setClipboard()
 	m_client->setClipboard(id, &clipboard);
 }
 
+void
+CServerProxy::setClipboardOffer()
+{
+	// parse
+	ClipboardID id;
+	UInt32 seqNum;
+	CString data;
+	CProtocolUtil::readf(m_stream, kMsgDClipboardOffer + 4,
+							&id, &seqNum, &data);
+	LOG((CLOG_DEBUG "recv clipboard %d offer", id));
+
+	// validate
+	if (id >= kClipboardEnd) {
+		return;
+	}
+	CClipboardOffer& offer = m_recvOffer[id];
+	if (!offer.unmarshall(data)) {
+		return;
+	}
+
+	// the server's clipboard changed so anything we're still sending
+	// it is out of date
+	m_clipboardTransfer.cancel(id);
+
+	// use what we have.  the rest is deferred until it's needed.
+	CClipboardOffer::CFormatList missing;
+	if (offer.resolve(m_clipboardCache, &missing)) {
+		LOG((CLOG_DEBUG "clipboard %d is cached", id));
+	}
+	else {
+		LOG((CLOG_DEBUG "deferring %d clipboard %d formats", missing.size(), id));
+	}
+	m_recvQueried[id] = false;
+
+	// forward
+	CClipboard clipboard;
+	offer.get(&clipboard, 0);
+	if (offer.isComplete()) {
+		offer.clear();
+	}
+	m_client->setClipboard(id, &clipboard);
+}
+
+void
+CServerProxy::onClipboardRequested(ClipboardID id)
+{
+	// ignore if we're not waiting on formats or we've already asked
+	CClipboardOffer& offer = m_recvOffer[id];
+	if (!offer.isValid() || m_recvQueried[id]) {
+		return;
+	}
+
+	// ask for what's still missing
+	CClipboardOffer::CFormatList missing;
+	if (!offer.resolve(m_clipboardCache, &missing)) {
+		LOG((CLOG_DEBUG "query %d clipboard %d formats", missing.size(), id));
+		CProtocolUtil::writef(m_stream, kMsgQClipboard, id, &missing);
+		m_recvQueried[id] = true;
+		return;
+	}
+
+	// the cache got the missing data since the offer arrived
+	CClipboard clipboard;
+	offer.get(&clipboard, 0);
+	offer.clear();
+	m_client->setClipboard(id, &clipboard);
+}
+
+bool
+CServerProxy::hasClipboardOffers() const
+{
+	return m_minorVersion >= 4;
+}
+
+void
+CServerProxy::setClipboardFormats()
+{
+	// parse.  nothing to do until the last chunk arrives.
+	ClipboardID id;
+	CString data;
+	bool done, failed;
+	if (!m_clipboardTransfer.recv(&id, &data, &done, &failed) || !done) {
+		return;
+	}
+	LOG((CLOG_DEBUG "recv clipboard %d formats size=%d%s", id, data.size(), failed ? " (failed)" : ""));
+
+	// ignore if we didn't ask for formats for the current offer.  the
+	// offer is cleared or replaced if the clipboard was grabbed since.
+	CClipboardOffer& offer = m_recvOffer[id];
+	if (!offer.isValid() || !m_recvQueried[id]) {
+		LOG((CLOG_DEBUG "ignoring clipboard %d formats for old offer", id));
+		return;
+	}
+	m_recvQueried[id] = false;
+
+	// formats the server didn't send can't be had.  drop them so
+	// pastes waiting on them fail now instead of timing out.
+	if (failed || !offer.fill(data, m_clipboardCache)) {
+		LOG((CLOG_DEBUG "server can't supply some clipboard %d formats", id));
+		offer.dropMissing();
+	}
+
+	// forward
+	CClipboard clipboard;
+	offer.get(&clipboard, 0);
+	offer.clear();
+	m_client->setClipboard(id, &clipboard);
+}
+
+void
+CServerProxy::queryClipboard()
+{
+	// parse
+	ClipboardID id;
+	CClipboardOffer::CFormatList formats;
+	CProtocolUtil::readf(m_stream, kMsgQClipboard + 4, &id, &formats);
+	LOG((CLOG_DEBUG "recv query for %d clipboard %d formats", formats.size(), id));
+
+	// validate
+	if (id >= kClipboardEnd) {
+		return;
+	}
+
+	// convert the requested formats our offer listed without data.
+	// if we can't then tell the server so its paste fails now.
+	CClipboardOffer& offer = m_sentOffer[id];
+	if (!offer.isValid()) {
+		m_clipboardTransfer.fail(id);
+		return;
+	}
+	UInt32 missing = offer.getMissing(formats);
+	if (missing != 0) {
+		CClipboard clipboard;
+		if (!m_client->getClipboardFormats(id, &clipboard, missing)) {
+			LOG((CLOG_DEBUG "can't convert clipboard %d", id));
+			m_clipboardTransfer.fail(id);
+			return;
+		}
+		offer.fill(&clipboard, m_clipboardCache);
+	}
+
+	// send the requested data from our most recent offer
+	CString data = offer.marshallFormats(formats);
+	LOG((CLOG_DEBUG1 "sending clipboard %d formats size=%d", id, data.size()));
+	CSharedString sharedData;
+	sharedData.adopt(data);
+	m_clipboardTransfer.send(id, sharedData);
+}
+
 void
 CServerProxy::grabClipboard()
 {
@@ -546,6 +738,9 @@ CServerProxy::grabClipboard()
 		return;
 	}
 
+	// any clipboard data we're still sending is out of date
+	m_clipboardTransfer.cancel(id);
+
 	// forward
 	m_client->grabClipboard(id);
 }
@@ -17,6 +17,9 @@
 
 #include "ClipboardTypes.h"
 #include "KeyTypes.h"
+#include "CClipboardCache.h"
+#include "CClipboardOffer.h"
+#include "CClipboardTransfer.h"
 #include "CEvent.h"
 
 class CClient;
@@ -34,9 +37,10 @@ class CServerProxy {
 public:
 	/*!
 	Process messages from the server on \p stream and forward to
-	\p client.
+	\p client.  \p minorVersion is the negotiated protocol minor
+	version.
 	*/
-	CServerProxy(CClient* client, IStream* stream);
+	CServerProxy(CClient* client, IStream* stream, SInt16 minorVersion);
 	~CServerProxy();
 
 	//! @name manipulators
@@ -45,6 +49,19 @@ public:
 	void				onInfoChanged();
 	bool				onGrabClipboard(ClipboardID);
 	void				onClipboardChanged(ClipboardID, const IClipboard*);
+	void				onClipboardRequested(ClipboardID);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Test for clipboard offers
+	/*!
+	Returns true iff the server takes clipboard offers (protocol 1.4
+	and up).  The server then asks for the formats it needs so
+	onClipboardChanged() can be passed deferred formats.
+	*/
+	bool				hasClipboardOffers() const;
 
 	//@}
 
@@ -74,6 +91,9 @@ private:
 	void				enter();
 	void				leave();
 	void				setClipboard();
+	void				setClipboardOffer();
+	void				setClipboardFormats();
+	void				queryClipboard();
 	void				grabClipboard();
 	void				keyDown();
 	void				keyRepeat();
@@ -94,9 +114,17 @@ private:
 
 	CClient*			m_client;
 	IStream*			m_stream;
+	SInt16				m_minorVersion;
 
 	UInt32				m_seqNum;
 
+	// clipboard offers (protocol 1.4 and up)
+	CClipboardCache		m_clipboardCache;
+	CClipboardOffer		m_sentOffer[kClipboardEnd];
+	CClipboardOffer		m_recvOffer[kClipboardEnd];
+	bool				m_recvQueried[kClipboardEnd];
+	CClipboardTransfer	m_clipboardTransfer;
+
 	bool				m_compressMouse;
 	bool				m_compressMouseRelative;
 	SInt32				m_xMouse, m_yMouse;
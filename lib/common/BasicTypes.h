@@ -44,6 +44,14 @@
 #	endif
 #endif
 
+#if !defined(TYPE_OF_SIZE_8)
+#	if SIZEOF_LONG == 8
+#		define TYPE_OF_SIZE_8 long
+#	else
+#		define TYPE_OF_SIZE_8 long long
+#	endif
+#endif
+
 //
 // verify existence of required types
 //
@@ -57,6 +65,9 @@
 #if !defined(TYPE_OF_SIZE_4)
 #	error No 4 byte integer type
 #endif
+#if !defined(TYPE_OF_SIZE_8)
+#	error No 8 byte integer type
+#endif
 
 
 //
@@ -70,10 +81,12 @@
 typedef signed TYPE_OF_SIZE_1	SInt8;
 typedef signed TYPE_OF_SIZE_2	SInt16;
 typedef signed TYPE_OF_SIZE_4	SInt32;
+typedef signed TYPE_OF_SIZE_8	SInt64;
 
 typedef unsigned TYPE_OF_SIZE_1	UInt8;
 typedef unsigned TYPE_OF_SIZE_2	UInt16;
 typedef unsigned TYPE_OF_SIZE_4	UInt32;
+typedef unsigned TYPE_OF_SIZE_8	UInt64;
 
 //
 // clean up
@@ -82,5 +95,6 @@ typedef unsigned TYPE_OF_SIZE_4	UInt32;
 #undef TYPE_OF_SIZE_1
 #undef TYPE_OF_SIZE_2
 #undef TYPE_OF_SIZE_4
+#undef TYPE_OF_SIZE_8
 
 #endif
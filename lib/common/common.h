@@ -111,6 +111,7 @@
 #	define TYPE_OF_SIZE_1 __int8
 #	define TYPE_OF_SIZE_2 __int16
 #	define TYPE_OF_SIZE_4 __int32
+#	define TYPE_OF_SIZE_8 __int64
 #else
 #	define SIZE_OF_CHAR		1
 #	define SIZE_OF_SHORT	2
@@ -15,11 +15,30 @@
 #include "CCondVar.h"
 #include "CStopwatch.h"
 #include "CArch.h"
+#if MT_USE_FUTEX
+#	include <climits>
+#endif
 
 //
 // CCondVarBase
 //
 
+#if MT_USE_FUTEX
+
+CCondVarBase::CCondVarBase(CMutex* mutex) : 
+	m_mutex(mutex),
+	m_seq(0)
+{
+	assert(m_mutex != NULL);
+}
+
+CCondVarBase::~CCondVarBase()
+{
+	// do nothing
+}
+
+#else
+
 CCondVarBase::CCondVarBase(CMutex* mutex) : 
 	m_mutex(mutex)
 {
@@ -32,6 +51,8 @@ CCondVarBase::~CCondVarBase()
 	ARCH->closeCondVar(m_cond);
 }
 
+#endif
+
 void
 CCondVarBase::lock() const
 {
@@ -44,6 +65,24 @@ CCondVarBase::unlock() const
 	m_mutex->unlock();
 }
 
+#if MT_USE_FUTEX
+
+void
+CCondVarBase::signal()
+{
+	__sync_fetch_and_add(&m_seq, 1);
+	CMutex::futexWake(&m_seq, 1);
+}
+
+void
+CCondVarBase::broadcast()
+{
+	__sync_fetch_and_add(&m_seq, 1);
+	CMutex::futexWake(&m_seq, INT_MAX);
+}
+
+#else
+
 void
 CCondVarBase::signal()
 {
@@ -56,6 +95,8 @@ CCondVarBase::broadcast()
 	ARCH->broadcastCondVar(m_cond);
 }
 
+#endif
+
 bool
 CCondVarBase::wait(CStopwatch& timer, double timeout) const
 {
@@ -68,12 +109,44 @@ CCondVarBase::wait(CStopwatch& timer, double timeout) const
 	return wait(timeout);
 }
 
+#if MT_USE_FUTEX
+
+bool
+CCondVarBase::wait(double timeout) const
+{
+	// we don't use posix cancellation so, like the arch condition
+	// variable, wake up periodically to check for cancellation.  the
+	// caller always checks for spurious wakeups.
+	static const double maxCancellationLatency = 0.1;
+	if (timeout < 0.0 || timeout > maxCancellationLatency) {
+		timeout = maxCancellationLatency;
+	}
+
+	// see if we should cancel this thread
+	ARCH->testCancelThread();
+
+	// a signal after we unlock changes m_seq so we can't miss it
+	const int seq = m_seq;
+	m_mutex->unlock();
+	const bool signalled = CMutex::futexWait(&m_seq, seq, timeout);
+	m_mutex->lock();
+
+	// check for cancel again
+	ARCH->testCancelThread();
+
+	return signalled;
+}
+
+#else
+
 bool
 CCondVarBase::wait(double timeout) const
 {
 	return ARCH->waitCondVar(m_cond, m_mutex->m_mutex, timeout);
 }
 
+#endif
+
 CMutex*
 CCondVarBase::getMutex() const
 {
@@ -118,7 +118,12 @@ private:
 
 private:
 	CMutex*				m_mutex;
+#if MT_USE_FUTEX
+	// incremented on each signal or broadcast.  waiters sleep on it.
+	mutable volatile int	m_seq;
+#else
 	CArchCond			m_cond;
+#endif
 };
 
 //! Condition variable
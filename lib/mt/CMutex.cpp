@@ -14,6 +14,136 @@
 
 #include "CMutex.h"
 #include "CArch.h"
+#if MT_USE_FUTEX
+#	include <linux/futex.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#	include <errno.h>
+#	include <time.h>
+#	if !defined(FUTEX_PRIVATE_FLAG)
+#		define FUTEX_WAIT_PRIVATE	FUTEX_WAIT
+#		define FUTEX_WAKE_PRIVATE	FUTEX_WAKE
+#	endif
+#endif
+
+#if MT_USE_FUTEX
+
+// most spins a contended lock will do before sleeping
+static const int		s_maxSpin = 100;
+
+static
+bool
+canSpin()
+{
+	// spinning only helps if the owner can run while we spin
+	static const bool s_canSpin = (sysconf(_SC_NPROCESSORS_ONLN) > 1);
+	return s_canSpin;
+}
+
+static inline
+void
+cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+	__asm__ __volatile__("pause" ::: "memory");
+#else
+	__sync_synchronize();
+#endif
+}
+
+//
+// CMutex
+//
+
+CMutex::CMutex() :
+	m_state(0),
+	m_spin(0)
+{
+	// do nothing
+}
+
+CMutex::CMutex(const CMutex&) :
+	m_state(0),
+	m_spin(0)
+{
+	// do nothing
+}
+
+CMutex::~CMutex()
+{
+	assert(m_state == 0);
+}
+
+CMutex&
+CMutex::operator=(const CMutex&)
+{
+	return *this;
+}
+
+void
+CMutex::lockContended() const
+{
+	// spin while the owner is likely to let go soon.  the spin limit
+	// follows a running average of how long we've had to spin before.
+	// the average is only a hint so unsynchronized updates are fine.
+	if (canSpin()) {
+		const int maxSpin = (2 * m_spin + 10 < s_maxSpin) ?
+								2 * m_spin + 10 : s_maxSpin;
+		int spin = 0;
+		while (spin < maxSpin) {
+			++spin;
+			cpuRelax();
+			if (m_state == 0 &&
+				__sync_val_compare_and_swap(&m_state, 0, 1) == 0) {
+				m_spin += (spin - m_spin) / 8;
+				return;
+			}
+		}
+		m_spin += (spin - m_spin) / 8;
+	}
+
+	// mark the mutex contended and sleep until we get it.  we can't
+	// tell if other threads are still sleeping when we get it so we
+	// must leave it marked contended.
+	while (__sync_lock_test_and_set(&m_state, 2) != 0) {
+		futexWait(&m_state, 2, -1.0);
+	}
+}
+
+void
+CMutex::unlockContended() const
+{
+	m_state = 0;
+	__sync_synchronize();
+	futexWake(&m_state, 1);
+}
+
+bool
+CMutex::futexWait(volatile int* addr, int value, double timeout)
+{
+	struct timespec timespec;
+	struct timespec* timespecPtr = NULL;
+	if (timeout >= 0.0) {
+		timespec.tv_sec  = static_cast<time_t>(timeout);
+		timespec.tv_nsec = static_cast<long>(1.0e+9 *
+								(timeout - timespec.tv_sec));
+		timespecPtr      = &timespec;
+	}
+	if (syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE,
+							value, timespecPtr, NULL, 0) == -1) {
+		// EAGAIN means *addr != value and EINTR is a spurious wakeup
+		return (errno != ETIMEDOUT);
+	}
+	return true;
+}
+
+void
+CMutex::futexWake(volatile int* addr, int count)
+{
+	syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+#else // !MT_USE_FUTEX
 
 //
 // CMutex
@@ -51,3 +181,5 @@ CMutex::unlock() const
 {
 	ARCH->unlockMutex(m_mutex);
 }
+
+#endif
@@ -17,6 +17,11 @@
 
 #include "IArchMultithread.h"
 
+// on linux mutexes are built directly on futexes
+#if HAVE_LINUX_FUTEX_H && HAVE_SYS_SYSCALL_H
+#	define MT_USE_FUTEX 1
+#endif
+
 //! Mutual exclusion
 /*!
 A non-recursive mutual exclusion object.  Only one thread at a time can
@@ -25,6 +30,12 @@ will block until the mutex is unlocked.  At that time, if any threads are
 blocked, exactly one waiting thread will acquire the lock and continue
 running.  A thread may not lock a mutex it already owns the lock on;  if
 it tries it will deadlock itself.
+
+On linux the mutex is a word in the object manipulated with atomic
+operations.  An uncontended lock or unlock is inlined and never enters
+the kernel.  A contended lock spins briefly, adapting the spin count
+to how long the mutex has recently been held, then sleeps on a futex.
+Elsewhere the mutex is an \c CArchMutex.
 */
 class CMutex {
 public:
@@ -72,7 +83,48 @@ public:
 
 private:
 	friend class CCondVarBase;
+
+#if MT_USE_FUTEX
+	void				lockContended() const;
+	void				unlockContended() const;
+
+	// sleep while *addr == value for up to timeout seconds (forever if
+	// timeout < 0).  returns false iff the timeout expired.
+	static bool			futexWait(volatile int* addr,
+							int value, double timeout);
+
+	// wake up to count threads sleeping on addr
+	static void			futexWake(volatile int* addr, int count);
+
+	// the lock state is 0 when unlocked, 1 when locked and 2 when
+	// locked and there may be threads sleeping on the futex.
+	mutable volatile int	m_state;
+	mutable int				m_spin;
+#else
 	CArchMutex			m_mutex;
+#endif
 };
 
+#if MT_USE_FUTEX
+
+inline
+void
+CMutex::lock() const
+{
+	if (__sync_val_compare_and_swap(&m_state, 0, 1) != 0) {
+		lockContended();
+	}
+}
+
+inline
+void
+CMutex::unlock() const
+{
+	if (__sync_fetch_and_sub(&m_state, 1) != 1) {
+		unlockContended();
+	}
+}
+
+#endif
+
 #endif
@@ -91,6 +91,12 @@ CThread::getCurrentThread()
 	return CThread(ARCH->newCurrentThread());
 }
 
+IArchMultithread::ThreadID
+CThread::getCurrentThreadID()
+{
+	return ARCH->getIDOfCurrentThread();
+}
+
 void
 CThread::testCancel()
 {
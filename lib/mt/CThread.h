@@ -140,6 +140,14 @@ public:
 	*/
 	static CThread		getCurrentThread();
 
+	//! Get current thread's id
+	/*!
+	Return the id of the calling thread.  This is equivalent to
+	getCurrentThread().getID() but doesn't create a CThread.
+	*/
+	static IArchMultithread::ThreadID
+						getCurrentThreadID();
+
 	//! Test for cancellation
 	/*!
 	testCancel() does nothing but is a cancellation point.  Call
@@ -176,9 +184,10 @@ public:
 
 	//! Get the thread id
 	/*!
-	Returns an integer id for this thread.  This id must not be used to
-	check if two CThread objects refer to the same thread.  Use
-	operator==() for that.
+	Returns an integer id for this thread.  No two running threads
+	have the same id but an exited thread's id may be reused, so use
+	operator==() to check if two CThread objects refer to the same
+	thread.
 	*/
 	IArchMultithread::ThreadID
 						getID() const;
@@ -37,8 +37,8 @@ CSocketMultiplexer::CSocketMultiplexer() :
 	m_jobsReady(new CCondVar<bool>(m_mutex, false)),
 	m_jobListLock(new CCondVar<bool>(m_mutex, false)),
 	m_jobListLockLocked(new CCondVar<bool>(m_mutex, false)),
-	m_jobListLocker(NULL),
-	m_jobListLockLocker(NULL)
+	m_jobListLocker(0),
+	m_jobListLockLocker(0)
 {
 	assert(s_instance == NULL);
 
@@ -63,8 +63,6 @@ CSocketMultiplexer::~CSocketMultiplexer()
 	delete m_jobsReady;
 	delete m_jobListLock;
 	delete m_jobListLockLocked;
-	delete m_jobListLocker;
-	delete m_jobListLockLocker;
 	delete m_mutex;
 
 	// clean up jobs
@@ -150,6 +148,31 @@ CSocketMultiplexer::removeSocket(ISocket* socket)
 	unlockJobList();
 }
 
+void
+CSocketMultiplexer::updateSocket(ISocket* socket)
+{
+	assert(socket != NULL);
+
+	// prevent other threads from locking the job list
+	lockJobListLock();
+
+	// break thread out of poll
+	m_thread->unblockPollSocket();
+
+	// lock the job list
+	lockJobList();
+
+	// recollect poll entries.  pfds keeps its storage so this doesn't
+	// allocate.
+	CSocketJobMap::iterator i = m_socketJobMap.find(socket);
+	if (i != m_socketJobMap.end() && *(i->second) != NULL) {
+		m_update = true;
+	}
+
+	// unlock the job list
+	unlockJobList();
+}
+
 void
 CSocketMultiplexer::serviceThread(void*)
 {
@@ -198,20 +221,15 @@ CSocketMultiplexer::serviceThread(void*)
 			deleteCursor(cursor);
 		}
 
-		int status;
-		try {
-			// check for status
-			if (!pfds.empty()) {
-				status = ARCH->pollSocket(&pfds[0], pfds.size(), -1);
-			}
-			else {
-				status = 0;
+		// check for status
+		int status = 0;
+		if (!pfds.empty()) {
+			IArchNetwork::CSocketError error;
+			status = ARCH->pollSocket(&pfds[0], pfds.size(), -1, &error);
+			if (error.m_type != IArchNetwork::kSocketOK) {
+				LOG((CLOG_WARN "error in socket multiplexer: %s", error.m_what.c_str()));
 			}
 		}
-		catch (XArchNetwork& e) {
-			LOG((CLOG_WARN "error in socket multiplexer: %s", e.what().c_str()));
-			status = 0;
-		}
 
 		if (status != 0) {
 			// iterate over socket jobs, invoking each and saving the
@@ -232,13 +250,24 @@ CSocketMultiplexer::serviceThread(void*)
 					ISocketMultiplexerJob* job    = *jobCursor;
 					ISocketMultiplexerJob* newJob = job->run(read, write, error);
 
-					// save job, if different
+					// save job, if different.  if it's the same job then
+					// its interests may have changed so update its poll
+					// entry in place.
 					if (newJob != job) {
 						CLock lock(m_mutex);
 						delete job;
 						*jobCursor = newJob;
 						m_update   = true;
 					}
+					else {
+						pfds[i].m_events = 0;
+						if (job->isReadable()) {
+							pfds[i].m_events |= IArchNetwork::kPOLLIN;
+						}
+						if (job->isWritable()) {
+							pfds[i].m_events |= IArchNetwork::kPOLLOUT;
+						}
+					}
 					++i;
 				}
 
@@ -310,7 +339,7 @@ CSocketMultiplexer::lockJobListLock()
 
 	// take ownership of the lock on the lock
 	*m_jobListLockLocked = true;
-	m_jobListLockLocker  = new CThread(CThread::getCurrentThread());
+	m_jobListLockLocker  = CThread::getCurrentThreadID();
 }
 
 void
@@ -319,7 +348,7 @@ CSocketMultiplexer::lockJobList()
 	CLock lock(m_mutex);
 
 	// make sure we're the one that called lockJobListLock()
-	assert(*m_jobListLockLocker == CThread::getCurrentThread());
+	assert(m_jobListLockLocker == CThread::getCurrentThreadID());
 
 	// wait for the job list lock
 	while (*m_jobListLock) {
@@ -329,7 +358,7 @@ CSocketMultiplexer::lockJobList()
 	// take ownership of the lock
 	*m_jobListLock      = true;
 	m_jobListLocker     = m_jobListLockLocker;
-	m_jobListLockLocker = NULL;
+	m_jobListLockLocker = 0;
 
 	// release the lock on the lock
 	*m_jobListLockLocked = false;
@@ -342,11 +371,10 @@ CSocketMultiplexer::unlockJobList()
 	CLock lock(m_mutex);
 
 	// make sure we're the one that called lockJobList()
-	assert(*m_jobListLocker == CThread::getCurrentThread());
+	assert(m_jobListLocker == CThread::getCurrentThreadID());
 
 	// release the lock
-	delete m_jobListLocker;
-	m_jobListLocker = NULL;
+	m_jobListLocker = 0;
 	*m_jobListLock  = false;
 	m_jobListLock->signal();
 
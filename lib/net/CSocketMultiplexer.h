@@ -15,6 +15,7 @@
 #ifndef CSOCKETMULTIPLEXER_H
 #define CSOCKETMULTIPLEXER_H
 
+#include "IArchMultithread.h"
 #include "IArchNetwork.h"
 #include "stdlist.h"
 #include "stdmap.h"
@@ -42,6 +43,11 @@ public:
 
 	void				removeSocket(ISocket*);
 
+	// the job for the socket has changed its interest in readability
+	// or writability in place.  jobs that change from within run()
+	// don't need to call this.
+	void				updateSocket(ISocket*);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -98,8 +104,10 @@ private:
 	CCondVar<bool>*		m_jobsReady;
 	CCondVar<bool>*		m_jobListLock;
 	CCondVar<bool>*		m_jobListLockLocked;
-	CThread*			m_jobListLocker;
-	CThread*			m_jobListLockLocker;
+
+	// ids of the threads holding the locks, 0 if none
+	IArchMultithread::ThreadID	m_jobListLocker;
+	IArchMultithread::ThreadID	m_jobListLockLocker;
 
 	CSocketJobs			m_socketJobs;
 	CSocketJobMap		m_socketJobMap;
@@ -22,6 +22,7 @@
 #include "CLock.h"
 #include "CMutex.h"
 #include "IEventQueue.h"
+#include "CLog.h"
 #include "CArch.h"
 #include "XArch.h"
 
@@ -101,15 +102,25 @@ CTCPListenSocket::getEventTarget() const
 IDataSocket*
 CTCPListenSocket::accept()
 {
+	// use the non-throwing accept.  it returns NULL without an error
+	// if there was nothing to accept after all.  errors such as a
+	// client resetting before we accept are routine;  either way we
+	// keep listening.
+	IArchNetwork::CSocketError error;
+	CArchSocket archSocket = ARCH->acceptSocket(m_socket, NULL, &error);
+	if (error.m_type != IArchNetwork::kSocketOK) {
+		LOG((CLOG_DEBUG "accept failed: %s", error.m_what.c_str()));
+	}
+
 	try {
-		IDataSocket* socket =
-			new CTCPSocket(ARCH->acceptSocket(m_socket, NULL));
-		if (socket != NULL) {
-			CSocketMultiplexer::getInstance()->addSocket(this,
+		IDataSocket* socket = NULL;
+		if (archSocket != NULL) {
+			socket = new CTCPSocket(archSocket);
+		}
+		CSocketMultiplexer::getInstance()->addSocket(this,
 							new TSocketMultiplexerMethodJob<CTCPListenSocket>(
 								this, &CTCPListenSocket::serviceListening,
 								m_socket, true, false));
-		}
 		return socket;
 	}
 	catch (XArchNetwork&) {
@@ -53,7 +53,7 @@ CTCPSocket::CTCPSocket(CArchSocket socket) :
 	// socket starts in connected state
 	init();
 	onConnected();
-	setJob(newJob());
+	updateJob();
 }
 
 CTCPSocket::~CTCPSocket()
@@ -83,10 +83,11 @@ CTCPSocket::bind(const CNetworkAddress& addr)
 void
 CTCPSocket::close()
 {
-	// remove ourself from the multiplexer
-	setJob(NULL);
+	// remove ourself from the multiplexer.  it deletes our job.
+	CSocketMultiplexer::getInstance()->removeSocket(this);
 
 	CLock lock(&m_mutex);
+	m_job = NULL;
 
 	// clear buffers and enter disconnected state
 	if (m_connected) {
@@ -165,7 +166,7 @@ CTCPSocket::write(const void* buffer, UInt32 n)
 
 	// make sure we're waiting to write
 	if (wasEmpty) {
-		setJob(newJob());
+		updateJob();
 	}
 }
 
@@ -201,7 +202,7 @@ CTCPSocket::shutdownInput()
 		}
 	}
 	if (useNewJob) {
-		setJob(newJob());
+		updateJob();
 	}
 }
 
@@ -228,7 +229,7 @@ CTCPSocket::shutdownOutput()
 		}
 	}
 	if (useNewJob) {
-		setJob(newJob());
+		updateJob();
 	}
 }
 
@@ -272,7 +273,7 @@ CTCPSocket::connect(const CNetworkAddress& addr)
 			throw XSocketConnect(e.what());
 		}
 	}
-	setJob(newJob());
+	updateJob();
 }
 
 void
@@ -282,6 +283,7 @@ CTCPSocket::init()
 	m_connected = false;
 	m_readable  = false;
 	m_writable  = false;
+	m_job       = NULL;
 
 	try {
 		// turn off Nagle algorithm.  we send lots of very short messages
@@ -302,15 +304,32 @@ CTCPSocket::init()
 }
 
 void
-CTCPSocket::setJob(ISocketMultiplexerJob* job)
+CTCPSocket::updateJob()
 {
-	// multiplexer will delete the old job
+	// note -- must not have m_mutex locked on entry
+
+	ISocketMultiplexerJob* job;
+	bool isNew;
+	{
+		CLock lock(&m_mutex);
+		ISocketMultiplexerJob* oldJob = m_job;
+		job   = newJob();
+		isNew = (job != oldJob);
+	}
+
+	// only hand the multiplexer a job it doesn't have yet.  once it
+	// has our job it may delete it at any time we don't hold m_mutex
+	// so refer to an existing job by socket instead.  the multiplexer
+	// deletes the old job when we remove the socket.
 	if (job == NULL) {
 		CSocketMultiplexer::getInstance()->removeSocket(this);
 	}
-	else {
+	else if (isNew) {
 		CSocketMultiplexer::getInstance()->addSocket(this, job);
 	}
+	else {
+		CSocketMultiplexer::getInstance()->updateSocket(this);
+	}
 }
 
 ISocketMultiplexerJob*
@@ -318,27 +337,38 @@ CTCPSocket::newJob()
 {
 	// note -- must have m_mutex locked on entry
 
+	// choose the method and interests for our current state
+	TSocketMultiplexerMethodJob<CTCPSocket>::Method method;
+	bool readable, writable;
 	if (m_socket == NULL) {
+		m_job = NULL;
 		return NULL;
 	}
 	else if (!m_connected) {
 		assert(!m_readable);
-		if (!(m_readable || m_writable)) {
-			return NULL;
-		}
-		return new TSocketMultiplexerMethodJob<CTCPSocket>(
-								this, &CTCPSocket::serviceConnecting,
-								m_socket, m_readable, m_writable);
+		method   = &CTCPSocket::serviceConnecting;
+		readable = m_readable;
+		writable = m_writable;
 	}
 	else {
-		if (!(m_readable || (m_writable && (m_outputBuffer.getSize() > 0)))) {
-			return NULL;
-		}
-		return new TSocketMultiplexerMethodJob<CTCPSocket>(
-								this, &CTCPSocket::serviceConnected,
-								m_socket, m_readable,
-								m_writable && (m_outputBuffer.getSize() > 0));
+		method   = &CTCPSocket::serviceConnected;
+		readable = m_readable;
+		writable = (m_writable && (m_outputBuffer.getSize() > 0));
+	}
+	if (!(readable || writable)) {
+		m_job = NULL;
+		return NULL;
 	}
+
+	// change our job or make one if we don't have one
+	if (m_job != NULL) {
+		m_job->setMethod(method, readable, writable);
+	}
+	else {
+		m_job = new TSocketMultiplexerMethodJob<CTCPSocket>(
+								this, method, m_socket, readable, writable);
+	}
+	return m_job;
 }
 
 void
@@ -416,12 +446,10 @@ CTCPSocket::serviceConnecting(ISocketMultiplexerJob* job,
 	// report the socket as being writable so synergy is able to time
 	// out the attempt.)
 	if (error || true) {
-		try {
-			// connection may have failed or succeeded
-			ARCH->throwErrorOnSocket(m_socket);
-		}
-		catch (XArchNetwork& e) {
-			sendConnectionFailedEvent(e.what().c_str());
+		// connection may have failed or succeeded
+		IArchNetwork::CSocketError socketError;
+		if (ARCH->getErrorOnSocket(m_socket, &socketError)) {
+			sendConnectionFailedEvent(socketError.m_what.c_str());
 			onDisconnected();
 			return newJob();
 		}
@@ -450,13 +478,18 @@ CTCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 
 	bool needNewJob = false;
 
+	// errors here are routine (e.g. the peer hanging up) so use the
+	// non-throwing socket calls
+	IArchNetwork::CSocketError socketError;
+
 	if (write) {
-		try {
-			// write data
-			UInt32 n = m_outputBuffer.getSize();
-			const void* buffer = m_outputBuffer.peek(n);
-			n = (UInt32)ARCH->writeSocket(m_socket, buffer, n);
+		// write data
+		UInt32 n = m_outputBuffer.getSize();
+		const void* buffer = m_outputBuffer.peek(n);
+		n = (UInt32)ARCH->writeSocket(m_socket, buffer, n, &socketError);
 
+		switch (socketError.m_type) {
+		case IArchNetwork::kSocketOK:
 			// discard written data
 			if (n > 0) {
 				m_outputBuffer.pop(n);
@@ -467,8 +500,9 @@ CTCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 					needNewJob = true;
 				}
 			}
-		}
-		catch (XArchNetworkShutdown&) {
+			break;
+
+		case IArchNetwork::kSocketShutdown:
 			// remote read end of stream hungup.  our output side
 			// has therefore shutdown.
 			onOutputShutdown();
@@ -478,63 +512,74 @@ CTCPSocket::serviceConnected(ISocketMultiplexerJob* job,
 				m_connected = false;
 			}
 			needNewJob = true;
-		}
-		catch (XArchNetworkDisconnected&) {
+			break;
+
+		case IArchNetwork::kSocketDisconnected:
 			// stream hungup
 			onDisconnected();
 			sendEvent(getDisconnectedEvent());
 			needNewJob = true;
-		}
-		catch (XArchNetwork& e) {
+			break;
+
+		case IArchNetwork::kSocketFailed:
 			// other write error
-			LOG((CLOG_WARN "error writing socket: %s", e.what().c_str()));
+			LOG((CLOG_WARN "error writing socket: %s", socketError.m_what.c_str()));
 			onDisconnected();
 			sendEvent(getOutputErrorEvent());
 			sendEvent(getDisconnectedEvent());
 			needNewJob = true;
+			break;
 		}
 	}
 
 	if (read && m_readable) {
-		try {
-			UInt8 buffer[4096];
-			size_t n = ARCH->readSocket(m_socket, buffer, sizeof(buffer));
-			if (n > 0) {
-				bool wasEmpty = (m_inputBuffer.getSize() == 0);
-
-				// slurp up as much as possible
-				do {
-					m_inputBuffer.write(buffer, n);
-					n = ARCH->readSocket(m_socket, buffer, sizeof(buffer));
-				} while (n > 0);
-
-				// send input ready if input buffer was empty
-				if (wasEmpty) {
-					sendEvent(getInputReadyEvent());
-				}
+		UInt8 buffer[4096];
+		socketError = IArchNetwork::CSocketError();
+		size_t n = ARCH->readSocket(m_socket, buffer, sizeof(buffer),
+								&socketError);
+		if (n > 0) {
+			bool wasEmpty = (m_inputBuffer.getSize() == 0);
+
+			// slurp up as much as possible
+			do {
+				m_inputBuffer.write(buffer, n);
+				n = ARCH->readSocket(m_socket, buffer, sizeof(buffer),
+								&socketError);
+			} while (n > 0);
+
+			// send input ready if input buffer was empty
+			if (wasEmpty && socketError.m_type == IArchNetwork::kSocketOK) {
+				sendEvent(getInputReadyEvent());
 			}
-			else {
-				// remote write end of stream hungup.  our input side
-				// has therefore shutdown but don't flush our buffer
-				// since there's still data to be read.
-				sendEvent(getInputShutdownEvent());
-				if (!m_writable && m_inputBuffer.getSize() == 0) {
-					sendEvent(getDisconnectedEvent());
-					m_connected = false;
-				}
-				m_readable = false;
-				needNewJob = true;
+		}
+		else if (socketError.m_type == IArchNetwork::kSocketOK) {
+			// remote write end of stream hungup.  our input side
+			// has therefore shutdown but don't flush our buffer
+			// since there's still data to be read.
+			sendEvent(getInputShutdownEvent());
+			if (!m_writable && m_inputBuffer.getSize() == 0) {
+				sendEvent(getDisconnectedEvent());
+				m_connected = false;
 			}
+			m_readable = false;
+			needNewJob = true;
 		}
-		catch (XArchNetworkDisconnected&) {
+
+		switch (socketError.m_type) {
+		case IArchNetwork::kSocketOK:
+			break;
+
+		case IArchNetwork::kSocketDisconnected:
 			// stream hungup
 			sendEvent(getDisconnectedEvent());
 			onDisconnected();
 			needNewJob = true;
-		}
-		catch (XArchNetwork& e) {
+			break;
+
+		default:
 			// ignore other read error
-			LOG((CLOG_WARN "error reading socket: %s", e.what().c_str()));
+			LOG((CLOG_WARN "error reading socket: %s", socketError.m_what.c_str()));
+			break;
 		}
 	}
 
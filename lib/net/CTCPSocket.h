@@ -24,6 +24,8 @@
 class CMutex;
 class CThread;
 class ISocketMultiplexerJob;
+template <class T>
+class TSocketMultiplexerMethodJob;
 
 //! TCP data socket
 /*!
@@ -55,7 +57,7 @@ public:
 private:
 	void				init();
 
-	void				setJob(ISocketMultiplexerJob*);
+	void				updateJob();
 	ISocketMultiplexerJob*	newJob();
 	void				sendConnectionFailedEvent(const char*);
 	void				sendEvent(CEvent::Type);
@@ -81,6 +83,11 @@ private:
 	bool				m_connected;
 	bool				m_readable;
 	bool				m_writable;
+
+	// our job with the multiplexer, NULL if we're not multiplexed.  we
+	// keep one job and change its interests rather than replacing it.
+	// the multiplexer owns it.
+	TSocketMultiplexerMethodJob<CTCPSocket>*	m_job;
 };
 
 #endif
@@ -33,6 +33,15 @@ public:
 							CArchSocket socket, bool readable, bool writeable);
 	virtual ~TSocketMultiplexerMethodJob();
 
+	//! Change the method and interests
+	/*!
+	Change the method run() invokes and whether the job is interested
+	in readability and writability, so a socket can keep one job for
+	its lifetime.  Changes made outside of run() must be followed by
+	CSocketMultiplexer::updateSocket().
+	*/
+	void				setMethod(Method method, bool readable, bool writable);
+
 	// IJob overrides
 	virtual ISocketMultiplexerJob*
 						run(bool readable, bool writable, bool error);
@@ -70,6 +79,17 @@ TSocketMultiplexerMethodJob<T>::~TSocketMultiplexerMethodJob()
 	ARCH->closeSocket(m_socket);
 }
 
+template <class T>
+inline
+void
+TSocketMultiplexerMethodJob<T>::setMethod(Method method,
+				bool readable, bool writable)
+{
+	m_method   = method;
+	m_readable = readable;
+	m_writable = writable;
+}
+
 template <class T>
 inline
 ISocketMultiplexerJob*
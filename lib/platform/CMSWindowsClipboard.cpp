@@ -176,6 +176,35 @@ CMSWindowsClipboard::get(EFormat format) const
 	return converter->toIClipboard(win32Data);
 }
 
+void
+CMSWindowsClipboard::addShared(EFormat format, const CSharedString& data)
+{
+	// the system clipboard keeps its own copy so there's nothing to share
+	add(format, data.str());
+}
+
+CSharedString
+CMSWindowsClipboard::getShared(EFormat format) const
+{
+	CString data = get(format);
+	CSharedString result;
+	result.adopt(data);
+	return result;
+}
+
+void
+CMSWindowsClipboard::addDeferred(EFormat)
+{
+	// we can't wait for data so leave the format out.  the screen
+	// asks for the data right away.
+}
+
+bool
+CMSWindowsClipboard::isDeferred(EFormat) const
+{
+	return false;
+}
+
 void
 CMSWindowsClipboard::clearConverters()
 {
@@ -311,12 +311,19 @@ CMSWindowsScreen::leave()
 }
 
 bool
-CMSWindowsScreen::setClipboard(ClipboardID, const IClipboard* src)
+CMSWindowsScreen::setClipboard(ClipboardID id, const IClipboard* src)
 {
 	CMSWindowsClipboard dst(m_window);
 	if (src != NULL) {
-		// save clipboard data
-		return CClipboard::copy(&dst, src);
+		// save clipboard data.  we can't wait for deferred data so
+		// ask for it now.
+		if (!CClipboard::copy(&dst, src)) {
+			return false;
+		}
+		if (IClipboard::hasDeferred(src)) {
+			sendClipboardEvent(getClipboardRequestedEvent(), id);
+		}
+		return true;
 	}
 	else {
 		// assert clipboard ownership
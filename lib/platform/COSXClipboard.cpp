@@ -191,6 +191,35 @@ COSXClipboard::get(EFormat format) const
 	return converter->toIClipboard(result);
 }
 
+void
+COSXClipboard::addShared(EFormat format, const CSharedString& data)
+{
+	// the system clipboard keeps its own copy so there's nothing to share
+	add(format, data.str());
+}
+
+CSharedString
+COSXClipboard::getShared(EFormat format) const
+{
+	CString data = get(format);
+	CSharedString result;
+	result.adopt(data);
+	return result;
+}
+
+void
+COSXClipboard::addDeferred(EFormat)
+{
+	// we can't wait for data so leave the format out.  the screen
+	// asks for the data right away.
+}
+
+bool
+COSXClipboard::isDeferred(EFormat) const
+{
+	return false;
+}
+
 void
 COSXClipboard::clearConverters()
 {
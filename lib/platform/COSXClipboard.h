@@ -38,6 +38,10 @@ public:
 	virtual Time		getTime() const;
 	virtual bool		has(EFormat) const;
 	virtual CString		get(EFormat) const;
+	virtual void		addShared(EFormat, const CSharedString& data);
+	virtual CSharedString	getShared(EFormat) const;
+	virtual void		addDeferred(EFormat);
+	virtual bool		isDeferred(EFormat) const;
 
 private:
 	void				clearConverters();
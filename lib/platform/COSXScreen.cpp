@@ -689,14 +689,18 @@ COSXScreen::leave()
 }
 
 bool
-COSXScreen::setClipboard(ClipboardID, const IClipboard* src)
+COSXScreen::setClipboard(ClipboardID id, const IClipboard* src)
 {
 	COSXClipboard dst;
 	if (src != NULL) {
-		// save clipboard data
+		// save clipboard data.  we can't wait for deferred data so
+		// ask for it now.
 		if (!CClipboard::copy(&dst, src)) {
 			return false;
 		}
+		if (IClipboard::hasDeferred(src)) {
+			sendClipboardEvent(getClipboardRequestedEvent(), id);
+		}
 	}
 	else {
 		// assert clipboard ownership
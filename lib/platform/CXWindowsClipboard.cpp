@@ -25,8 +25,12 @@
 #include "CArch.h"
 #include "stdvector.h"
 #include <cstdio>
+#include <cstring>
 #include <X11/Xatom.h>
 
+// largest INCR transfer we'll preallocate for
+static const UInt32		s_maxINCRReserve = 64 * 1024 * 1024;
+
 //
 // CXWindowsClipboard
 //
@@ -104,6 +108,9 @@ CXWindowsClipboard::lost(Time time)
 		m_owner    = false;
 		m_timeLost = time;
 		clearCache();
+
+		// we'll never get deferred data now
+		failDeferredRequests();
 	}
 }
 
@@ -171,9 +178,20 @@ CXWindowsClipboard::addSimpleRequest(Window requestor,
 		IXWindowsClipboardConverter* converter = getConverter(target);
 		if (converter != NULL) {
 			IClipboard::EFormat clipboardFormat = converter->getFormat();
-			if (m_added[clipboardFormat]) {
+			if (m_added[clipboardFormat] && m_deferred[clipboardFormat]) {
+				// we don't have the data yet.  the reply waits until
+				// we do.
+				LOG((CLOG_DEBUG1 "waiting for deferred format %d", clipboardFormat));
+				CReply* reply = new CReply(requestor, target, time,
+								property, CSharedString(), None, 0);
+				reply->m_waiting = true;
+				insertReply(reply);
+				return true;
+			}
+			else if (m_added[clipboardFormat]) {
 				try {
-					data   = converter->fromIClipboard(m_data[clipboardFormat]);
+					data   = converter->fromIClipboard(
+										m_data[clipboardFormat].str());
 					format = converter->getDataSize();
 					type   = converter->getAtom();
 				}
@@ -187,8 +205,10 @@ CXWindowsClipboard::addSimpleRequest(Window requestor,
 	if (type != None) {
 		// success
 		LOG((CLOG_DEBUG1 "success"));
+		CSharedString sharedData;
+		sharedData.adopt(data);
 		insertReply(new CReply(requestor, target, time,
-								property, data, type, format));
+								property, sharedData, type, format));
 		return true;
 	}
 	else {
@@ -246,6 +266,28 @@ CXWindowsClipboard::destroyRequest(Window requestor)
 	return true;
 }
 
+void
+CXWindowsClipboard::failDeferredRequests()
+{
+	replyDeferred(true);
+}
+
+bool
+CXWindowsClipboard::hasDeferredRequests() const
+{
+	for (CReplyMap::const_iterator index = m_replies.begin();
+								index != m_replies.end(); ++index) {
+		const CReplyList& replies = index->second;
+		for (CReplyList::const_iterator index2 = replies.begin();
+								index2 != replies.end(); ++index2) {
+			if ((*index2)->m_waiting) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
 Window
 CXWindowsClipboard::getWindow() const
 {
@@ -258,6 +300,44 @@ CXWindowsClipboard::getSelection() const
 	return m_selection;
 }
 
+bool
+CXWindowsClipboard::getFormats(IClipboard* dst,
+				UInt32 formats, Time time) const
+{
+	assert(dst != NULL);
+
+	// give dst the time the owner took the selection so callers can
+	// tell when it changes without comparing data we haven't fetched
+	bool success = false;
+	if (open(time)) {
+		if (dst->open(getTime())) {
+			if (dst->empty()) {
+				listFormats();
+				for (SInt32 format = 0; format != kNumFormats; ++format) {
+					EFormat eFormat = (EFormat)format;
+					if ((formats & (1u << format)) != 0) {
+						fetchFormat(eFormat);
+					}
+					if (!m_added[format]) {
+						continue;
+					}
+					if (m_pending[format] || m_deferred[format]) {
+						dst->addDeferred(eFormat);
+					}
+					else {
+						dst->addShared(eFormat, m_data[format]);
+					}
+				}
+				success = true;
+			}
+			dst->close();
+		}
+		close();
+	}
+
+	return success;
+}
+
 bool
 CXWindowsClipboard::empty()
 {
@@ -299,8 +379,9 @@ CXWindowsClipboard::add(EFormat format, const CString& data)
 
 	LOG((CLOG_DEBUG "add %d bytes to clipboard %d format: %d", data.size(), m_id, format));
 
-	m_data[format]  = data;
-	m_added[format] = true;
+	m_data[format]     = CSharedString(data);
+	m_added[format]    = true;
+	m_deferred[format] = false;
 
 	// FIXME -- set motif clipboard item?
 }
@@ -354,6 +435,11 @@ CXWindowsClipboard::close() const
 
 	m_motif = false;
 	m_open  = false;
+
+	// answer requests waiting for data we now have
+	if (m_owner) {
+		const_cast<CXWindowsClipboard*>(this)->replyDeferred(false);
+	}
 }
 
 IClipboard::Time
@@ -377,10 +463,54 @@ CXWindowsClipboard::get(EFormat format) const
 {
 	assert(m_open);
 
+	fillCache();
+	return m_data[format].str();
+}
+
+void
+CXWindowsClipboard::addShared(EFormat format, const CSharedString& data)
+{
+	assert(m_open);
+	assert(m_owner);
+
+	LOG((CLOG_DEBUG "add %d bytes to clipboard %d format: %d", data.size(), m_id, format));
+
+	m_data[format]     = data;
+	m_added[format]    = true;
+	m_deferred[format] = false;
+}
+
+void
+CXWindowsClipboard::addDeferred(EFormat format)
+{
+	assert(m_open);
+	assert(m_owner);
+
+	LOG((CLOG_DEBUG "add deferred format %d to clipboard %d", format, m_id));
+
+	m_data[format]     = CSharedString();
+	m_added[format]    = true;
+	m_deferred[format] = true;
+}
+
+CSharedString
+CXWindowsClipboard::getShared(EFormat format) const
+{
+	assert(m_open);
+
 	fillCache();
 	return m_data[format];
 }
 
+bool
+CXWindowsClipboard::isDeferred(EFormat format) const
+{
+	assert(m_open);
+
+	fillCache();
+	return m_deferred[format];
+}
+
 void
 CXWindowsClipboard::clearConverters()
 {
@@ -457,9 +587,12 @@ CXWindowsClipboard::doClearCache()
 {
 	m_checkCache = false;
 	m_cached     = false;
+	m_listed     = false;
 	for (SInt32 index = 0; index < kNumFormats; ++index) {
-		m_data[index]  = "";
-		m_added[index] = false;
+		m_data[index]     = CSharedString();
+		m_added[index]    = false;
+		m_deferred[index] = false;
+		m_pending[index]  = false;
 	}
 }
 
@@ -476,6 +609,15 @@ CXWindowsClipboard::fillCache() const
 void
 CXWindowsClipboard::doFillCache()
 {
+	// formats that were only listed get filled like the rest
+	for (SInt32 index = 0; index < kNumFormats; ++index) {
+		if (m_pending[index]) {
+			m_added[index]   = false;
+			m_pending[index] = false;
+		}
+	}
+	m_listed = false;
+
 	if (m_motif) {
 		motifFillCache();
 	}
@@ -487,6 +629,164 @@ CXWindowsClipboard::doFillCache()
 	m_cacheTime  = m_timeOwned;
 }
 
+void
+CXWindowsClipboard::listFormats() const
+{
+	// list the selection's formats if not already listed or cached
+	checkCache();
+	if (!m_cached && !m_listed) {
+		const_cast<CXWindowsClipboard*>(this)->doListFormats();
+	}
+}
+
+void
+CXWindowsClipboard::doListFormats()
+{
+	LOG((CLOG_DEBUG "ICCCM list clipboard %d", m_id));
+
+	// fill the cache the usual way if we can't get the targets
+	Atom target;
+	CString data;
+	if (m_motif || !icccmGetSelection(m_atomTargets, &target, &data) ||
+		(target != m_atomAtom && target != m_atomTargets)) {
+		doFillCache();
+		return;
+	}
+
+	CXWindowsUtil::convertAtomProperty(data);
+	const Atom* targets = reinterpret_cast<const Atom*>(data.data());
+	const UInt32 numTargets = data.size() / sizeof(Atom);
+	LOG((CLOG_DEBUG "  available targets: %s", CXWindowsUtil::atomsToString(m_display, targets, numTargets).c_str()));
+
+	// note each format we have a converter for
+	bool listed = false;
+	for (ConverterList::const_iterator index = m_converters.begin();
+								index != m_converters.end(); ++index) {
+		IXWindowsClipboardConverter* converter = *index;
+		IClipboard::EFormat format = converter->getFormat();
+		if (m_added[format]) {
+			continue;
+		}
+		for (UInt32 i = 0; i < numTargets; ++i) {
+			if (converter->getAtom() == targets[i]) {
+				m_added[format]   = true;
+				m_pending[format] = true;
+				listed            = true;
+				LOG((CLOG_DEBUG "  listed format %d for target %s", format, CXWindowsUtil::atomToString(m_display, targets[i]).c_str()));
+				break;
+			}
+		}
+	}
+
+	// some owners don't report all the targets they support.  if we
+	// didn't recognize any then try each converter's target instead.
+	if (!listed) {
+		doFillCache();
+		return;
+	}
+
+	m_checkCache = false;
+	m_listed     = true;
+	m_cacheTime  = m_timeOwned;
+}
+
+void
+CXWindowsClipboard::fetchFormat(EFormat format) const
+{
+	listFormats();
+	if (m_pending[format]) {
+		const_cast<CXWindowsClipboard*>(this)->doFetchFormat(format);
+	}
+}
+
+void
+CXWindowsClipboard::doFetchFormat(EFormat format)
+{
+	m_added[format]   = false;
+	m_pending[format] = false;
+
+	// try each converter for the format in order of preference.  like
+	// icccmFillCache() we ask for the converter's target directly.
+	for (ConverterList::const_iterator index = m_converters.begin();
+								index != m_converters.end(); ++index) {
+		IXWindowsClipboardConverter* converter = *index;
+		if (converter->getFormat() != format) {
+			continue;
+		}
+
+		// get the data
+		const Atom target = converter->getAtom();
+		Atom actualTarget;
+		CString targetData;
+		if (!icccmGetSelection(target, &actualTarget, &targetData)) {
+			LOG((CLOG_DEBUG1 "  no data for target %s", CXWindowsUtil::atomToString(m_display, target).c_str()));
+			continue;
+		}
+
+		// add to clipboard and note we've done it
+		CString clipboardData = converter->toIClipboard(targetData);
+		m_data[format].adopt(clipboardData);
+		m_added[format] = true;
+		LOG((CLOG_DEBUG "  added format %d for target %s (%u %s)", format, CXWindowsUtil::atomToString(m_display, target).c_str(), targetData.size(), targetData.size() == 1 ? "byte" : "bytes"));
+		return;
+	}
+}
+
+void
+CXWindowsClipboard::replyDeferred(bool fail)
+{
+	bool changed = false;
+	for (CReplyMap::iterator index = m_replies.begin();
+								index != m_replies.end(); ++index) {
+		CReplyList& replies = index->second;
+		for (CReplyList::iterator index2 = replies.begin();
+								index2 != replies.end(); ++index2) {
+			CReply* reply = *index2;
+			if (!reply->m_waiting) {
+				continue;
+			}
+
+			// keep waiting if the data is still deferred
+			IXWindowsClipboardConverter* converter =
+				getConverter(reply->m_target);
+			IClipboard::EFormat clipboardFormat = (converter == NULL) ?
+				kNumFormats : converter->getFormat();
+			if (!fail && converter != NULL &&
+				m_added[clipboardFormat] && m_deferred[clipboardFormat]) {
+				continue;
+			}
+			reply->m_waiting = false;
+			changed          = true;
+
+			// convert the data.  if we can't then fail the request.
+			if (!fail && converter != NULL && m_added[clipboardFormat]) {
+				try {
+					CString data    = converter->fromIClipboard(
+										m_data[clipboardFormat].str());
+					reply->m_data.adopt(data);
+					reply->m_format = converter->getDataSize();
+					reply->m_type   = converter->getAtom();
+				}
+				catch (...) {
+					// ignore -- cannot convert
+				}
+			}
+			if (reply->m_type == None) {
+				LOG((CLOG_DEBUG1 "failed deferred request from 0x%08x", reply->m_requestor));
+				reply->m_property = None;
+			}
+			else {
+				LOG((CLOG_DEBUG1 "completed deferred request from 0x%08x", reply->m_requestor));
+			}
+		}
+	}
+
+	// send the replies we can
+	if (changed) {
+		pushReplies();
+	}
+}
+
 void
 CXWindowsClipboard::icccmFillCache()
 {
@@ -550,7 +850,8 @@ CXWindowsClipboard::icccmFillCache()
 
 		// add to clipboard and note we've done it
 		IClipboard::EFormat format = converter->getFormat();
-		m_data[format]  = converter->toIClipboard(targetData);
+		CString clipboardData      = converter->toIClipboard(targetData);
+		m_data[format].adopt(clipboardData);
 		m_added[format] = true;
 		LOG((CLOG_DEBUG "  added format %d for target %s (%u %s)", format, CXWindowsUtil::atomToString(m_display, target).c_str(), targetData.size(), targetData.size() == 1 ? "byte" : "bytes"));
 	}
@@ -788,7 +1089,8 @@ CXWindowsClipboard::motifFillCache()
 
 		// add to clipboard and note we've done it
 		IClipboard::EFormat format = converter->getFormat();
-		m_data[format]  = converter->toIClipboard(targetData);
+		CString clipboardData      = converter->toIClipboard(targetData);
+		m_data[format].adopt(clipboardData);
 		m_added[format] = true;
 		LOG((CLOG_DEBUG "  added format %d for target %s", format, CXWindowsUtil::atomToString(m_display, target).c_str()));
 	}
@@ -870,7 +1172,7 @@ CXWindowsClipboard::insertMultipleReply(Window requestor,
 
 	// add reply for MULTIPLE request
 	insertReply(new CReply(requestor, m_atomMultiple,
-								time, property, CString(), None, 32));
+								time, property, CSharedString(), None, 32));
 
 	return true;
 }
@@ -981,19 +1283,28 @@ CXWindowsClipboard::sendReply(CReply* reply)
 		return true;
 	}
 
+	// can't send anything until we have the data
+	if (reply->m_waiting) {
+		return false;
+	}
+
 	// start in failed state if property is None
 	bool failed = (reply->m_property == None);
 	if (!failed) {
 		LOG((CLOG_DEBUG1 "clipboard: setting property on 0x%08x,%d,%d", reply->m_requestor, reply->m_target, reply->m_property));
 
 		// send using INCR if already sending incrementally or if reply
-		// is too large, otherwise just send it.
-		const UInt32 maxRequestSize = 3 * XMaxRequestSize(m_display);
+		// is too large, otherwise just send it.  each chunk is as large
+		// as a single request allows so large transfers need few
+		// round trips.
+		const UInt32 maxRequestSize =
+							CXWindowsUtil::getMaxPropertySize(m_display);
 		const bool useINCR = (reply->m_data.size() > maxRequestSize);
 
-		// send INCR reply if incremental and we haven't replied yet
+		// send INCR reply if incremental and we haven't replied yet.
+		// Xlib takes format 32 data as an array of long.
 		if (useINCR && !reply->m_replied) {
-			UInt32 size = reply->m_data.size();
+			long size = static_cast<long>(reply->m_data.size());
 			if (!CXWindowsUtil::setWindowProperty(m_display,
 								reply->m_requestor, reply->m_property,
 								&size, 4, m_atomINCR, 32)) {
@@ -1429,8 +1740,18 @@ CXWindowsClipboard::CICCCMGetClipboard::processEvent(
 		else {
 			m_incr   = true;
 
-			// discard INCR data
-			*m_data = "";
+			// the INCR data is a lower bound on the size of the data.
+			// make room for it up front so the chunks don't have to
+			// regrow the buffer.  the size comes from another client
+			// so don't trust absurd values.
+			UInt32 size = 0;
+			if (m_data->size() - oldSize >= sizeof(size)) {
+				memcpy(&size, m_data->data() + oldSize, sizeof(size));
+			}
+			m_data->erase(oldSize);
+			if (size <= s_maxINCRReserve) {
+				m_data->reserve(size);
+			}
 		}
 	}
 
@@ -1482,6 +1803,7 @@ CXWindowsClipboard::CReply::CReply(Window requestor, Atom target, ::Time time) :
 	m_property(None),
 	m_replied(false),
 	m_done(false),
+	m_waiting(false),
 	m_data(),
 	m_type(None),
 	m_format(32),
@@ -1491,13 +1813,15 @@ CXWindowsClipboard::CReply::CReply(Window requestor, Atom target, ::Time time) :
 }
 
 CXWindowsClipboard::CReply::CReply(Window requestor, Atom target, ::Time time,
-				Atom property, const CString& data, Atom type, int format) :
+				Atom property, const CSharedString& data,
+				Atom type, int format) :
 	m_requestor(requestor),
 	m_target(target),
 	m_time(time),
 	m_property(property),
 	m_replied(false),
 	m_done(false),
+	m_waiting(false),
 	m_data(data),
 	m_type(type),
 	m_format(format),
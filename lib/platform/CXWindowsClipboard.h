@@ -69,6 +69,22 @@ public:
 	*/
 	bool				destroyRequest(Window requestor);
 
+	//! Fail requests for deferred data
+	/*!
+	Sends a failure reply to every selection request that's waiting
+	for deferred data (see IClipboard::addDeferred()).  Requests that
+	are waiting get their data when it's added and the clipboard is
+	closed.
+	*/
+	void				failDeferredRequests();
+
+	//! Check for requests for deferred data
+	/*!
+	Returns true iff any selection request is waiting for deferred
+	data.
+	*/
+	bool				hasDeferredRequests() const;
+
 	//! Get window
 	/*!
 	Returns the clipboard's window (passed the c'tor).
@@ -82,6 +98,17 @@ public:
 	*/
 	Atom				getSelection() const;
 
+	//! Copy some formats of the clipboard
+	/*!
+	Like IClipboard::copy() except only formats whose bit (1 << format)
+	is set in \c formats are converted.  The other available formats
+	are added to \c dst as deferred.  If the selection reports its
+	targets then only those are read to learn the available formats.
+	The time of \c dst is the time the owner took the selection.
+	*/
+	bool				getFormats(IClipboard* dst,
+							UInt32 formats, Time) const;
+
 	// IClipboard overrides
 	virtual bool		empty();
 	virtual void		add(EFormat, const CString& data);
@@ -90,6 +117,10 @@ public:
 	virtual Time		getTime() const;
 	virtual bool		has(EFormat) const;
 	virtual CString		get(EFormat) const;
+	virtual void		addShared(EFormat, const CSharedString& data);
+	virtual CSharedString	getShared(EFormat) const;
+	virtual void		addDeferred(EFormat);
+	virtual bool		isDeferred(EFormat) const;
 
 private:
 	// remove all converters from our list
@@ -127,6 +158,20 @@ private:
 	void				fillCache() const;
 	void				doFillCache();
 
+	// note the formats of the selection without converting them.  the
+	// formats are added and pending until fetched or the cache is
+	// filled.  selections that don't report their targets are filled.
+	void				listFormats() const;
+	void				doListFormats();
+
+	// convert a pending format
+	void				fetchFormat(EFormat) const;
+	void				doFetchFormat(EFormat);
+
+	// reply to requests waiting for deferred data that we now have.
+	// if fail is true then fail all waiting requests.
+	void				replyDeferred(bool fail);
+
 	//
 	// helper classes
 	//
@@ -219,7 +264,7 @@ private:
 	public:
 		CReply(Window, Atom target, ::Time);
 		CReply(Window, Atom target, ::Time, Atom property,
-							const CString& data, Atom type, int format);
+							const CSharedString& data, Atom type, int format);
 
 	public:
 		// information about the request
@@ -234,8 +279,12 @@ private:
 		// true iff the reply has sent its last message
 		bool			m_done;
 
-		// the data to send and its type and format
-		CString			m_data;
+		// true iff the reply is waiting for deferred data
+		bool			m_waiting;
+
+		// the data to send and its type and format.  the data is
+		// shared so large replies aren't copied.
+		CSharedString	m_data;
 		Atom			m_type;
 		int				m_format;
 
@@ -297,9 +346,12 @@ private:
 	// the added/cached clipboard data
 	mutable bool		m_checkCache;
 	bool				m_cached;
+	bool				m_listed;
 	Time				m_cacheTime;
 	bool				m_added[kNumFormats];
-	CString				m_data[kNumFormats];
+	bool				m_deferred[kNumFormats];
+	bool				m_pending[kNumFormats];
+	CSharedString		m_data[kNumFormats];
 
 	// conversion request replies
 	CReplyMap			m_replies;
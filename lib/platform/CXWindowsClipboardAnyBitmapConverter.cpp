@@ -121,6 +121,11 @@ CXWindowsClipboardAnyBitmapConverter::getDataSize() const
 CString
 CXWindowsClipboardAnyBitmapConverter::fromIClipboard(const CString& bmp) const
 {
+	// make sure data is big enough for a BMP info header
+	if (bmp.size() <= 40) {
+		return CString();
+	}
+
 	// fill BMP info header with native-endian data
 	CBMPInfoHeader infoHeader;
 	const UInt8* rawBMPInfoHeader = reinterpret_cast<const UInt8*>(bmp.data());
@@ -181,7 +186,10 @@ CXWindowsClipboardAnyBitmapConverter::toIClipboard(const CString& image) const
 	toLE(dst, static_cast<UInt32>(0));
 	toLE(dst, static_cast<UInt32>(0));
 
-	// construct image
-	return CString(reinterpret_cast<const char*>(infoHeader),
-							sizeof(infoHeader)) + rawBMP;
+	// construct image with a single allocation and copy of the pixels
+	CString bmp;
+	bmp.reserve(sizeof(infoHeader) + rawBMP.size());
+	bmp.append(reinterpret_cast<const char*>(infoHeader), sizeof(infoHeader));
+	bmp.append(rawBMP);
+	return bmp;
 }
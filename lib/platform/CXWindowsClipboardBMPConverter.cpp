@@ -109,7 +109,13 @@ CXWindowsClipboardBMPConverter::fromIClipboard(const CString& bmp) const
 	toLE(dst, static_cast<UInt16>(0));
 	toLE(dst, static_cast<UInt16>(0));
 	toLE(dst, static_cast<UInt32>(14 + 40));
-	return CString(reinterpret_cast<const char*>(header), 14) + bmp;
+
+	// build the image with a single allocation and copy of the pixels
+	CString image;
+	image.reserve(sizeof(header) + bmp.size());
+	image.append(reinterpret_cast<const char*>(header), sizeof(header));
+	image.append(bmp);
+	return image;
 }
 
 CString
@@ -128,12 +134,14 @@ CXWindowsClipboardBMPConverter::toIClipboard(const CString& bmp) const
 
 	// get offset to image data
 	UInt32 offset = fromLEU32(rawBMPHeader + 10);
-
-	// construct BMP
-	if (offset == 14 + 40) {
-		return bmp.substr(14);
-	}
-	else {
-		return bmp.substr(14, 40) + bmp.substr(offset, bmp.size() - offset);
+	if (offset < 14 + 40 || offset > bmp.size()) {
+		return CString();
 	}
+
+	// construct BMP.  copy the pixels once straight into the result.
+	CString image;
+	image.reserve(40 + bmp.size() - offset);
+	image.append(bmp, 14, 40);
+	image.append(bmp, offset, bmp.size() - offset);
+	return image;
 }
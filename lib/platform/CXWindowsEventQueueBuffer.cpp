@@ -16,6 +16,7 @@
 #include "CLock.h"
 #include "CThread.h"
 #include "CEvent.h"
+#include "CLog.h"
 #include "IEventQueue.h"
 #if HAVE_POLL
 #	include <poll.h>
@@ -133,8 +134,19 @@ CXWindowsEventQueueBuffer::getEvent(CEvent& event, UInt32& dataID)
 	// push out pending events
 	flush();
 
+	// read all the events the X server has sent so far in one go.  the
+	// events stay in Xlib's queue rather than one of our own because
+	// the screen and clipboard look ahead in that queue, for example
+	// to detect key repeats and to skip past mouse warps.
+	if (XEventsQueued(m_display, QueuedAlready) == 0) {
+		XEventsQueued(m_display, QueuedAfterReading);
+	}
+
 	// get next event
 	XNextEvent(m_display, &m_event);
+	if (m_event.xany.type == MotionNotify) {
+		compressMotion();
+	}
 
 	// process event
 	if (m_event.xany.type == ClientMessage &&
@@ -179,7 +191,10 @@ bool
 CXWindowsEventQueueBuffer::isEmpty() const
 {
 	CLock lock(&m_mutex);
-	return (XPending(m_display) == 0);
+
+	// avoid the flush and read in XPending() if we already have events
+	return (XEventsQueued(m_display, QueuedAlready) == 0 &&
+			XPending(m_display) == 0);
 }
 
 CEventQueueTimer*
@@ -194,12 +209,44 @@ CXWindowsEventQueueBuffer::deleteTimer(CEventQueueTimer* timer) const
 	delete timer;
 }
 
+void
+CXWindowsEventQueueBuffer::compressMotion()
+{
+	// note -- m_mutex must be locked on entry
+
+	// replace the motion event with the last of the motion events on
+	// the same window that immediately follow it.  only the final
+	// position matters.  any other event, including motion sent by
+	// the screen to mark a warp, ends the run so motion stays in order
+	// with keys, buttons and warps.
+	if (m_event.xmotion.send_event) {
+		return;
+	}
+	UInt32 n = 0;
+	XEvent xevent;
+	while (XEventsQueued(m_display, QueuedAlready) > 0) {
+		XPeekEvent(m_display, &xevent);
+		if (xevent.xany.type != MotionNotify ||
+			xevent.xmotion.send_event ||
+			xevent.xmotion.window != m_event.xmotion.window) {
+			break;
+		}
+		XNextEvent(m_display, &m_event);
+		++n;
+	}
+	if (n > 0) {
+		LOG((CLOG_DEBUG2 "compressed %d motion events", n));
+	}
+}
+
 void
 CXWindowsEventQueueBuffer::flush()
 {
 	// note -- m_mutex must be locked on entry
 
-	// flush the posted event list to the X server
+	// flush the posted event list to the X server.  this also flushes
+	// any other pending requests, notably input faked by the screen
+	// while handling the last event, which doesn't flush on its own.
 	for (size_t i = 0; i < m_postedEvents.size(); ++i) {
 		XSendEvent(m_display, m_window, False, 0, &m_postedEvents[i]);
 	}
@@ -40,6 +40,7 @@ public:
 	virtual void		deleteTimer(CEventQueueTimer*) const;
 
 private:
+	void				compressMotion();
 	void				flush();
 
 private:
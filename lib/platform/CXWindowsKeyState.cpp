@@ -15,8 +15,14 @@
 #include "CXWindowsKeyState.h"
 #include "CXWindowsUtil.h"
 #include "CLog.h"
+#include "CSharedString.h"
 #include "CStringUtil.h"
+#include "CArch.h"
+#include "Version.h"
+#include "stdfstream.h"
 #include "stdmap.h"
+#include <algorithm>
+#include <stdio.h>
 #if X_DISPLAY_MISSING
 #	error X11 is required to build synergy
 #else
@@ -30,8 +36,36 @@
 #endif
 #endif
 
+#if HAVE_XKB_EXTENSION
+// name of the file, in the user's directory, caching the XKB keysym
+// map and the version of its format
+static const char*		s_keysymMapCacheName    = ".synergy-keymap";
+static const int		s_keysymMapCacheVersion = 1;
+
+// sanity limit on the number of each kind of entry per keycode in
+// the keysym map cache
+static const size_t		s_keysymMapCacheMaxEntries = 4096;
+
+static
+void
+hashValue(UInt64& hash, UInt32 x)
+{
+	UInt8 buffer[4];
+	buffer[0] = static_cast<UInt8>((x >> 24) & 0xff);
+	buffer[1] = static_cast<UInt8>((x >> 16) & 0xff);
+	buffer[2] = static_cast<UInt8>((x >>  8) & 0xff);
+	buffer[3] = static_cast<UInt8>( x        & 0xff);
+	hash = CSharedString::hash(buffer, 4, hash);
+}
+#endif
+
 CXWindowsKeyState::CXWindowsKeyState(Display* display, bool useXKB) :
-	m_display(display)
+	m_display(display),
+	m_xkbMinKeycode(0),
+	m_xkbNumGroups(-1),
+	m_xkbUsedLastGood(false),
+	m_changedFirst(0),
+	m_changedLast(-1)
 {
 	XGetKeyboardControl(m_display, &m_keyboardState);
 #if HAVE_XKB_EXTENSION
@@ -77,6 +111,23 @@ CXWindowsKeyState::setAutoRepeat(const XKeyboardState& state)
 	m_keyboardState = state;
 }
 
+void
+CXWindowsKeyState::setKeycodesChanged(int first, int last)
+{
+	if (m_changedFirst > m_changedLast) {
+		m_changedFirst = first;
+		m_changedLast  = last;
+	}
+	else {
+		if (first < m_changedFirst) {
+			m_changedFirst = first;
+		}
+		if (last > m_changedLast) {
+			m_changedLast = last;
+		}
+	}
+}
+
 KeyModifierMask
 CXWindowsKeyState::mapModifiersFromX(unsigned int state) const
 {
@@ -198,6 +249,10 @@ CXWindowsKeyState::getKeyMap(CKeyMap& keyMap)
 	{
 		updateKeysymMap(keyMap);
 	}
+
+	// we're up to date
+	m_changedFirst = 0;
+	m_changedLast  = -1;
 }
 
 void
@@ -251,7 +306,9 @@ CXWindowsKeyState::fakeKey(const Keystroke& keystroke)
 		}
 		break;
 	}
-	XFlush(m_display);
+
+	// no need to flush.  a key usually takes several keystrokes and
+	// the event queue buffer flushes them all together.
 }
 
 void
@@ -504,16 +561,6 @@ CXWindowsKeyState::updateKeysymMap(CKeyMap& keyMap)
 void
 CXWindowsKeyState::updateKeysymMapXKB(CKeyMap& keyMap)
 {
-	static const XkbKTMapEntryRec defMapEntry = {
-		True,		// active
-		0,			// level
-		{
-			0,		// mods.mask
-			0,		// mods.real_mods
-			0		// mods.vmods
-		}
-	};
-
 	LOG((CLOG_DEBUG1 "XKB mapping"));
 
 	// find the number of groups
@@ -525,15 +572,6 @@ CXWindowsKeyState::updateKeysymMapXKB(CKeyMap& keyMap)
 		}
 	}
 
-	// prepare map from X modifier to KeyModifierMask
-	std::vector<int> modifierLevel(maxNumGroups * 8, 4);
-	m_modifierFromX.clear();
-	m_modifierFromX.resize(maxNumGroups * 8);
-	m_modifierToX.clear();
-
-	// prepare map from KeyID to KeyCode
-	m_keyCodeFromKey.clear();
-
 	// Hack to deal with VMware.  When a VMware client grabs input the
 	// player clears out the X modifier map for whatever reason.  We're
 	// notified of the change and arrive here to discover that there
@@ -542,193 +580,304 @@ CXWindowsKeyState::updateKeysymMapXKB(CKeyMap& keyMap)
 	// of modifiers when there are no modifiers.  If there are modifiers
 	// we update the last known good set.
 	bool useLastGoodModifiers = !hasModifiersXKB();
+
+	// we only need to rescan the changed keycodes unless something
+	// that affects every keycode changed
+	int minKeycode = m_xkb->min_key_code;
+	int maxKeycode = m_xkb->max_key_code;
+	int first      = std::max(m_changedFirst, minKeycode);
+	int last       = std::min(m_changedLast, maxKeycode);
+	bool rescanAll = (maxNumGroups != m_xkbNumGroups ||
+					useLastGoodModifiers != m_xkbUsedLastGood ||
+					minKeycode != m_xkbMinKeycode ||
+					m_xkbKeycodes.size() != static_cast<size_t>(maxKeycode + 1));
+	bool loaded    = false;
+	UInt64 hash    = 0;
+	if (rescanAll) {
+		first             = minKeycode;
+		last              = maxKeycode;
+		m_xkbMinKeycode   = minKeycode;
+		m_xkbNumGroups    = maxNumGroups;
+		m_xkbUsedLastGood = useLastGoodModifiers;
+		m_xkbKeycodes.clear();
+		m_xkbKeycodes.resize(maxKeycode + 1);
+
+		// try the cached scan of this keyboard.  we can't use it with
+		// the last known good modifiers since those aren't part of the
+		// keyboard description.
+		if (!useLastGoodModifiers) {
+			hash   = hashKeyboardXKB();
+			loaded = loadKeysymMapXKB(hash, maxNumGroups);
+		}
+	}
+	if (loaded) {
+		LOG((CLOG_DEBUG1 "using cached XKB mapping"));
+	}
+	else {
+		if (first <= last) {
+			LOG((CLOG_DEBUG1 "scanning keycodes %d to %d", first, last));
+		}
+		for (int i = first; i <= last; ++i) {
+			scanKeycodeXKB(static_cast<KeyCode>(i), maxNumGroups,
+								useLastGoodModifiers, m_xkbKeycodes[i]);
+		}
+		if (rescanAll && !useLastGoodModifiers) {
+			saveKeysymMapXKB(hash, maxNumGroups);
+		}
+	}
+
+	// update the last known good modifiers
 	if (!useLastGoodModifiers) {
 		m_lastGoodXKBModifiers.clear();
+		for (int i = minKeycode; i <= maxKeycode; ++i) {
+			const XKBModifierMap& goodModifiers =
+				m_xkbKeycodes[i].m_goodModifiers;
+			m_lastGoodXKBModifiers.insert(goodModifiers.begin(),
+								goodModifiers.end());
+		}
 	}
 
-	// check every button.  on this pass we save all modifiers as native
-	// X modifier masks.
-	CKeyMap::KeyItem item;
-	for (int i = m_xkb->min_key_code; i <= m_xkb->max_key_code; ++i) {
-		KeyCode keycode = static_cast<KeyCode>(i);
-		item.m_button   = static_cast<KeyButton>(keycode);
-		item.m_client   = 0;
-
-		// skip keys with no groups (they generate no symbols)
-		if (XkbKeyNumGroups(m_xkb, keycode) == 0) {
-			continue;
-		}
+	buildKeysymMapXKB(keyMap, maxNumGroups);
+}
 
-		// note half-duplex keys
-		const XkbBehavior& b = m_xkb->server->behaviors[keycode];
-		if ((b.type & XkbKB_OpMask) == XkbKB_Lock) {
-			keyMap.addHalfDuplexButton(item.m_button);
+void
+CXWindowsKeyState::scanKeycodeXKB(KeyCode keycode, int maxNumGroups,
+				bool useLastGoodModifiers, XKBKeycodeInfo& info)
+{
+	static const XkbKTMapEntryRec defMapEntry = {
+		True,		// active
+		0,			// level
+		{
+			0,		// mods.mask
+			0,		// mods.real_mods
+			0		// mods.vmods
 		}
+	};
 
-		// iterate over all groups
-		for (int group = 0; group < maxNumGroups; ++group) {
-			item.m_group = group;
-			int eGroup   = getEffectiveGroup(keycode, group);
+	info.m_halfDuplex = false;
+	info.m_items.clear();
+	info.m_modifiers.clear();
+	info.m_keyIDs.clear();
+	info.m_goodModifiers.clear();
 
-			// get key info
-			XkbKeyTypePtr type = XkbKeyKeyType(m_xkb, keycode, eGroup);
+	// skip keys with no groups (they generate no symbols)
+	if (XkbKeyNumGroups(m_xkb, keycode) == 0) {
+		return;
+	}
 
-			// set modifiers the item is sensitive to
-			item.m_sensitive = type->mods.mask;
+	// save all modifiers as native X modifier masks
+	CKeyMap::KeyItem item;
+	item.m_button = static_cast<KeyButton>(keycode);
+	item.m_client = 0;
+	item.m_dead   = false;
+
+	// note half-duplex keys
+	const XkbBehavior& b = m_xkb->server->behaviors[keycode];
+	if ((b.type & XkbKB_OpMask) == XkbKB_Lock) {
+		info.m_halfDuplex = true;
+	}
 
-			// iterate over all shift levels for the button (including none)
-			for (int j = -1; j < type->map_count; ++j) {
-				const XkbKTMapEntryRec* mapEntry =
-					((j == -1) ? &defMapEntry : type->map + j);
-				if (!mapEntry->active) {
-					continue;
-				}
-				int level = mapEntry->level;
-
-				// set required modifiers for this item
-				item.m_required = mapEntry->mods.mask;
-				if ((item.m_required & LockMask) != 0 &&
-					j != -1 && type->preserve != NULL &&
-					(type->preserve[j].mask & LockMask) != 0) {
-					// sensitive caps lock and we preserve caps-lock.
-					// preserving caps-lock means we Xlib functions would
-					// yield the capitialized KeySym so we'll adjust the
-					// level accordingly.
-					if ((level ^ 1) < type->num_levels) {
-						level ^= 1;
-					}
-				}
+	// iterate over all groups
+	for (int group = 0; group < maxNumGroups; ++group) {
+		item.m_group = group;
+		int eGroup   = getEffectiveGroup(keycode, group);
 
-				// get the keysym for this item
-				KeySym keysym = XkbKeySymEntry(m_xkb, keycode, level, eGroup);
+		// get key info
+		XkbKeyTypePtr type = XkbKeyKeyType(m_xkb, keycode, eGroup);
 
-				// check for group change actions, locking modifiers, and
-				// modifier masks.
-				item.m_lock         = false;
-				bool isModifier     = false;
-				UInt32 modifierMask = m_xkb->map->modmap[keycode];
-				if (XkbKeyHasActions(m_xkb, keycode)) {
-					XkbAction* action =
-						XkbKeyActionEntry(m_xkb, keycode, level, eGroup);
-					if (action->type == XkbSA_SetMods ||
-						action->type == XkbSA_LockMods) {
-						isModifier  = true;
+		// set modifiers the item is sensitive to
+		item.m_sensitive = type->mods.mask;
 
-						// note toggles
-						item.m_lock = (action->type == XkbSA_LockMods);
+		// iterate over all shift levels for the button (including none)
+		for (int j = -1; j < type->map_count; ++j) {
+			const XkbKTMapEntryRec* mapEntry =
+				((j == -1) ? &defMapEntry : type->map + j);
+			if (!mapEntry->active) {
+				continue;
+			}
+			int level = mapEntry->level;
+
+			// set required modifiers for this item
+			item.m_required = mapEntry->mods.mask;
+			if ((item.m_required & LockMask) != 0 &&
+				j != -1 && type->preserve != NULL &&
+				(type->preserve[j].mask & LockMask) != 0) {
+				// sensitive caps lock and we preserve caps-lock.
+				// preserving caps-lock means we Xlib functions would
+				// yield the capitialized KeySym so we'll adjust the
+				// level accordingly.
+				if ((level ^ 1) < type->num_levels) {
+					level ^= 1;
+				}
+			}
 
-						// maybe use action's mask
-						if ((action->mods.flags & XkbSA_UseModMapMods) == 0) {
-							modifierMask = action->mods.mask;
-						}
-					}
-					else if (action->type == XkbSA_SetGroup ||
-							action->type == XkbSA_LatchGroup ||
-							action->type == XkbSA_LockGroup) {
-						// ignore group change key
-						continue;
+			// get the keysym for this item
+			KeySym keysym = XkbKeySymEntry(m_xkb, keycode, level, eGroup);
+
+			// check for group change actions, locking modifiers, and
+			// modifier masks.
+			item.m_lock         = false;
+			bool isModifier     = false;
+			UInt32 modifierMask = m_xkb->map->modmap[keycode];
+			if (XkbKeyHasActions(m_xkb, keycode)) {
+				XkbAction* action =
+					XkbKeyActionEntry(m_xkb, keycode, level, eGroup);
+				if (action->type == XkbSA_SetMods ||
+					action->type == XkbSA_LockMods) {
+					isModifier  = true;
+
+					// note toggles
+					item.m_lock = (action->type == XkbSA_LockMods);
+
+					// maybe use action's mask
+					if ((action->mods.flags & XkbSA_UseModMapMods) == 0) {
+						modifierMask = action->mods.mask;
 					}
 				}
-				level = mapEntry->level;
-
-				// VMware modifier hack
-				if (useLastGoodModifiers) {
-					XKBModifierMap::const_iterator k =
-						m_lastGoodXKBModifiers.find(eGroup * 256 + keycode);
-					if (k != m_lastGoodXKBModifiers.end()) {
-						// Use last known good modifier
-						isModifier   = true;
-						level        = k->second.m_level;
-						modifierMask = k->second.m_mask;
-						item.m_lock  = k->second.m_lock;
-					}
+				else if (action->type == XkbSA_SetGroup ||
+						action->type == XkbSA_LatchGroup ||
+						action->type == XkbSA_LockGroup) {
+					// ignore group change key
+					continue;
 				}
-				else if (isModifier) {
-					// Save known good modifier
-					XKBModifierInfo& info =
-						m_lastGoodXKBModifiers[eGroup * 256 + keycode];
-					info.m_level = level;
-					info.m_mask  = modifierMask;
-					info.m_lock  = item.m_lock;
+			}
+			level = mapEntry->level;
+
+			// VMware modifier hack
+			if (useLastGoodModifiers) {
+				XKBModifierMap::const_iterator k =
+					m_lastGoodXKBModifiers.find(eGroup * 256 + keycode);
+				if (k != m_lastGoodXKBModifiers.end()) {
+					// Use last known good modifier
+					isModifier   = true;
+					level        = k->second.m_level;
+					modifierMask = k->second.m_mask;
+					item.m_lock  = k->second.m_lock;
 				}
+			}
+			else if (isModifier) {
+				// Save known good modifier
+				XKBModifierInfo& goodInfo =
+					info.m_goodModifiers[eGroup * 256 + keycode];
+				goodInfo.m_level = level;
+				goodInfo.m_mask  = modifierMask;
+				goodInfo.m_lock  = item.m_lock;
+			}
 
-				// record the modifier mask for this key.  don't bother
-				// for keys that change the group.
-				item.m_generates = 0;
-				UInt32 modifierBit =
-					CXWindowsUtil::getModifierBitForKeySym(keysym);
-				if (isModifier && modifierBit != kKeyModifierBitNone) {
-					item.m_generates = (1u << modifierBit);
-					for (SInt32 j = 0; j < 8; ++j) {
-						// skip modifiers this key doesn't generate
-						if ((modifierMask & (1u << j)) == 0) {
-							continue;
-						}
-
-						// skip keys that map to a modifier that we've
-						// already seen using fewer modifiers.  that is
-						// if this key must combine with other modifiers
-						// and we know of a key that combines with fewer
-						// modifiers (or no modifiers) then prefer the
-						// other key.
-						if (level >= modifierLevel[8 * group + j]) {
-							continue;
-						}
-						modifierLevel[8 * group + j] = level;
-
-						// save modifier
-						m_modifierFromX[8 * group + j] |= (1u << modifierBit);
-						m_modifierToX.insert(std::make_pair(
-								1u << modifierBit, 1u << j));
+			// record the modifier mask for this key.  don't bother
+			// for keys that change the group.
+			item.m_generates = 0;
+			UInt32 modifierBit =
+				CXWindowsUtil::getModifierBitForKeySym(keysym);
+			if (isModifier && modifierBit != kKeyModifierBitNone) {
+				item.m_generates = (1u << modifierBit);
+				for (SInt32 j = 0; j < 8; ++j) {
+					// skip modifiers this key doesn't generate
+					if ((modifierMask & (1u << j)) == 0) {
+						continue;
 					}
+
+					// save modifier
+					XKBModifierUse use;
+					use.m_group       = group;
+					use.m_level       = level;
+					use.m_xBit        = j;
+					use.m_modifierBit = modifierBit;
+					info.m_modifiers.push_back(use);
 				}
+			}
+
+			// handle special cases of just one keysym for the keycode
+			if (type->num_levels == 1) {
+				// if there are upper- and lowercase versions of the
+				// keysym then add both.
+				KeySym lKeysym, uKeysym;
+				XConvertCase(keysym, &lKeysym, &uKeysym);
+				if (lKeysym != uKeysym) {
+					if (j != -1) {
+						continue;
+					}
 
-				// handle special cases of just one keysym for the keycode
-				if (type->num_levels == 1) {
-					// if there are upper- and lowercase versions of the
-					// keysym then add both.
-					KeySym lKeysym, uKeysym;
-					XConvertCase(keysym, &lKeysym, &uKeysym);
-					if (lKeysym != uKeysym) {
-						if (j != -1) {
-							continue;
-						}
-
-						item.m_sensitive |= ShiftMask | LockMask;
-
-						KeyID lKeyID = CXWindowsUtil::mapKeySymToKeyID(lKeysym);
-						KeyID uKeyID = CXWindowsUtil::mapKeySymToKeyID(uKeysym);
-						if (lKeyID == kKeyNone || uKeyID == kKeyNone) {
-							continue;
-						}
-
-						item.m_id       = lKeyID;
-						item.m_required = 0;
-						keyMap.addKeyEntry(item);
-
-						item.m_id       = uKeyID;
-						item.m_required = ShiftMask;
-						keyMap.addKeyEntry(item);
-						item.m_required = LockMask;
-						keyMap.addKeyEntry(item);
-
-						if (group == 0) {
-							m_keyCodeFromKey.insert(
-									std::make_pair(lKeyID, keycode));
-							m_keyCodeFromKey.insert(
-									std::make_pair(uKeyID, keycode));
-						}
+					item.m_sensitive |= ShiftMask | LockMask;
+
+					KeyID lKeyID = CXWindowsUtil::mapKeySymToKeyID(lKeysym);
+					KeyID uKeyID = CXWindowsUtil::mapKeySymToKeyID(uKeysym);
+					if (lKeyID == kKeyNone || uKeyID == kKeyNone) {
 						continue;
 					}
-				}
 
-				// add entry
-				item.m_id = CXWindowsUtil::mapKeySymToKeyID(keysym);
-				keyMap.addKeyEntry(item);
-				if (group == 0) {
-					m_keyCodeFromKey.insert(std::make_pair(item.m_id, keycode));
+					item.m_id       = lKeyID;
+					item.m_required = 0;
+					info.m_items.push_back(item);
+
+					item.m_id       = uKeyID;
+					item.m_required = ShiftMask;
+					info.m_items.push_back(item);
+					item.m_required = LockMask;
+					info.m_items.push_back(item);
+
+					if (group == 0) {
+						info.m_keyIDs.push_back(lKeyID);
+						info.m_keyIDs.push_back(uKeyID);
+					}
+					continue;
 				}
 			}
+
+			// add entry
+			item.m_id = CXWindowsUtil::mapKeySymToKeyID(keysym);
+			info.m_items.push_back(item);
+			if (group == 0) {
+				info.m_keyIDs.push_back(item.m_id);
+			}
+		}
+	}
+}
+
+void
+CXWindowsKeyState::buildKeysymMapXKB(CKeyMap& keyMap, int maxNumGroups)
+{
+	// prepare map from X modifier to KeyModifierMask
+	std::vector<int> modifierLevel(maxNumGroups * 8, 4);
+	m_modifierFromX.clear();
+	m_modifierFromX.resize(maxNumGroups * 8);
+	m_modifierToX.clear();
+
+	// prepare map from KeyID to KeyCode
+	m_keyCodeFromKey.clear();
+
+	// add the scanned keys
+	for (size_t i = m_xkbMinKeycode; i < m_xkbKeycodes.size(); ++i) {
+		const XKBKeycodeInfo& info = m_xkbKeycodes[i];
+		KeyCode keycode            = static_cast<KeyCode>(i);
+		if (info.m_halfDuplex) {
+			keyMap.addHalfDuplexButton(static_cast<KeyButton>(keycode));
+		}
+		for (size_t j = 0; j < info.m_items.size(); ++j) {
+			keyMap.addKeyEntry(info.m_items[j]);
+		}
+		for (size_t j = 0; j < info.m_keyIDs.size(); ++j) {
+			m_keyCodeFromKey.insert(std::make_pair(info.m_keyIDs[j], keycode));
+		}
+		for (size_t j = 0; j < info.m_modifiers.size(); ++j) {
+			const XKBModifierUse& use = info.m_modifiers[j];
+			int index                 = 8 * use.m_group + use.m_xBit;
+
+			// skip keys that map to a modifier that we've
+			// already seen using fewer modifiers.  that is
+			// if this key must combine with other modifiers
+			// and we know of a key that combines with fewer
+			// modifiers (or no modifiers) then prefer the
+			// other key.
+			if (use.m_level >= modifierLevel[index]) {
+				continue;
+			}
+			modifierLevel[index] = use.m_level;
+
+			// save modifier
+			m_modifierFromX[index] |= (1u << use.m_modifierBit);
+			m_modifierToX.insert(std::make_pair(
+							1u << use.m_modifierBit, 1u << use.m_xBit));
 		}
 	}
 
@@ -738,6 +887,229 @@ CXWindowsKeyState::updateKeysymMapXKB(CKeyMap& keyMap)
 	// allow composition across groups
 	keyMap.allowGroupSwitchDuringCompose();
 }
+
+UInt64
+CXWindowsKeyState::hashKeyboardXKB() const
+{
+	// hash everything in the keyboard description that the scan uses
+	UInt64 hash = CSharedString::kHashInit;
+
+	// key types
+	XkbClientMapPtr map = m_xkb->map;
+	hashValue(hash, map->num_types);
+	for (int i = 0; i < map->num_types; ++i) {
+		const XkbKeyTypeRec& type = map->types[i];
+		hashValue(hash, type.mods.mask);
+		hashValue(hash, type.num_levels);
+		hashValue(hash, type.map_count);
+		for (int j = 0; j < type.map_count; ++j) {
+			hashValue(hash, type.map[j].active);
+			hashValue(hash, type.map[j].level);
+			hashValue(hash, type.map[j].mods.mask);
+			hashValue(hash, (type.preserve == NULL) ? 0u :
+								type.preserve[j].mask);
+		}
+	}
+
+	// keys
+	hashValue(hash, m_xkb->min_key_code);
+	hashValue(hash, m_xkb->max_key_code);
+	for (int i = m_xkb->min_key_code; i <= m_xkb->max_key_code; ++i) {
+		KeyCode keycode = static_cast<KeyCode>(i);
+		hashValue(hash, XkbKeyGroupInfo(m_xkb, keycode));
+		for (int group = 0; group < XkbNumKbdGroups; ++group) {
+			hashValue(hash, XkbKeyKeyTypeIndex(m_xkb, keycode, group));
+		}
+		hashValue(hash, m_xkb->server->behaviors[keycode].type);
+		hashValue(hash, map->modmap[keycode]);
+
+		int numSyms  = XkbKeyNumSyms(m_xkb, keycode);
+		KeySym* syms = XkbKeySymsPtr(m_xkb, keycode);
+		hashValue(hash, numSyms);
+		for (int j = 0; j < numSyms; ++j) {
+			hashValue(hash, static_cast<UInt32>(syms[j]));
+		}
+
+		if (XkbKeyHasActions(m_xkb, keycode)) {
+			int numActions     = XkbKeyNumActions(m_xkb, keycode);
+			XkbAction* actions = XkbKeyActionsPtr(m_xkb, keycode);
+			hashValue(hash, numActions);
+			for (int j = 0; j < numActions; ++j) {
+				hashValue(hash, actions[j].type);
+				hashValue(hash, actions[j].mods.flags);
+				hashValue(hash, actions[j].mods.mask);
+			}
+		}
+		else {
+			hashValue(hash, 0);
+		}
+	}
+
+	return hash;
+}
+
+bool
+CXWindowsKeyState::loadKeysymMapXKB(UInt64 hash, int maxNumGroups)
+{
+	CString path = getKeysymMapCachePath();
+	if (path.empty()) {
+		return false;
+	}
+	std::ifstream stream(path.c_str());
+	if (!stream) {
+		return false;
+	}
+
+	// check that the cache is for this keyboard and this synergy
+	int format, numGroups, minKeycode, maxKeycode;
+	UInt32 hashHigh, hashLow;
+	CString version;
+	stream >> format >> version >> hashHigh >> hashLow >>
+				numGroups >> minKeycode >> maxKeycode;
+	if (!stream ||
+		format != s_keysymMapCacheVersion ||
+		version != kVersion ||
+		hashHigh != static_cast<UInt32>(hash >> 32) ||
+		hashLow != static_cast<UInt32>(hash & 0xffffffffu) ||
+		numGroups != maxNumGroups ||
+		minKeycode != m_xkbMinKeycode ||
+		maxKeycode + 1 != static_cast<int>(m_xkbKeycodes.size())) {
+		return false;
+	}
+
+	// read each keycode
+	for (int i = minKeycode; i <= maxKeycode; ++i) {
+		XKBKeycodeInfo& info = m_xkbKeycodes[i];
+		int keycode, halfDuplex;
+		size_t numItems, numModifiers, numKeyIDs, numGoodModifiers;
+		stream >> keycode >> halfDuplex >> numItems >>
+				numModifiers >> numKeyIDs >> numGoodModifiers;
+		if (!stream || keycode != i ||
+			numItems > s_keysymMapCacheMaxEntries ||
+			numModifiers > s_keysymMapCacheMaxEntries ||
+			numKeyIDs > s_keysymMapCacheMaxEntries ||
+			numGoodModifiers > s_keysymMapCacheMaxEntries) {
+			return false;
+		}
+		info.m_halfDuplex = (halfDuplex != 0);
+
+		info.m_items.resize(numItems);
+		for (size_t j = 0; j < numItems; ++j) {
+			CKeyMap::KeyItem& item = info.m_items[j];
+			int lock;
+			stream >> item.m_id >> item.m_group >> item.m_required >>
+				item.m_sensitive >> item.m_generates >> lock;
+			if (!stream || item.m_group < 0 || item.m_group >= numGroups) {
+				return false;
+			}
+			item.m_button = static_cast<KeyButton>(keycode);
+			item.m_dead   = false;
+			item.m_lock   = (lock != 0);
+			item.m_client = 0;
+		}
+
+		info.m_modifiers.resize(numModifiers);
+		for (size_t j = 0; j < numModifiers; ++j) {
+			XKBModifierUse& use = info.m_modifiers[j];
+			stream >> use.m_group >> use.m_level >>
+				use.m_xBit >> use.m_modifierBit;
+			if (!stream || use.m_group < 0 || use.m_group >= numGroups ||
+				use.m_xBit >= 8 ||
+				use.m_modifierBit >=
+					static_cast<UInt32>(kKeyModifierNumBits)) {
+				return false;
+			}
+		}
+
+		info.m_keyIDs.resize(numKeyIDs);
+		for (size_t j = 0; j < numKeyIDs; ++j) {
+			stream >> info.m_keyIDs[j];
+		}
+
+		info.m_goodModifiers.clear();
+		for (size_t j = 0; j < numGoodModifiers; ++j) {
+			UInt32 key;
+			int level, lock;
+			XKBModifierInfo goodInfo;
+			stream >> key >> level >> goodInfo.m_mask >> lock;
+			goodInfo.m_level          = static_cast<unsigned char>(level);
+			goodInfo.m_lock           = (lock != 0);
+			info.m_goodModifiers[key] = goodInfo;
+		}
+		if (!stream) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void
+CXWindowsKeyState::saveKeysymMapXKB(UInt64 hash, int maxNumGroups) const
+{
+	CString path = getKeysymMapCachePath();
+	if (path.empty()) {
+		return;
+	}
+
+	// write to a temporary file then rename it so a reader never sees
+	// a partially written cache
+	CString tmpPath = path + ".tmp";
+	std::ofstream stream(tmpPath.c_str());
+	if (!stream) {
+		LOG((CLOG_DEBUG1 "can't write %s", tmpPath.c_str()));
+		return;
+	}
+	stream << s_keysymMapCacheVersion << " " << kVersion << "\n";
+	stream << static_cast<UInt32>(hash >> 32) << " " <<
+				static_cast<UInt32>(hash & 0xffffffffu) << " " <<
+				maxNumGroups << " " << m_xkbMinKeycode << " " <<
+				(m_xkbKeycodes.size() - 1) << "\n";
+	for (size_t i = m_xkbMinKeycode; i < m_xkbKeycodes.size(); ++i) {
+		const XKBKeycodeInfo& info = m_xkbKeycodes[i];
+		stream << i << " " << (info.m_halfDuplex ? 1 : 0) << " " <<
+				info.m_items.size() << " " <<
+				info.m_modifiers.size() << " " <<
+				info.m_keyIDs.size() << " " <<
+				info.m_goodModifiers.size() << "\n";
+		for (size_t j = 0; j < info.m_items.size(); ++j) {
+			const CKeyMap::KeyItem& item = info.m_items[j];
+			stream << item.m_id << " " << item.m_group << " " <<
+				item.m_required << " " << item.m_sensitive << " " <<
+				item.m_generates << " " << (item.m_lock ? 1 : 0) << "\n";
+		}
+		for (size_t j = 0; j < info.m_modifiers.size(); ++j) {
+			const XKBModifierUse& use = info.m_modifiers[j];
+			stream << use.m_group << " " << use.m_level << " " <<
+				use.m_xBit << " " << use.m_modifierBit << "\n";
+		}
+		for (size_t j = 0; j < info.m_keyIDs.size(); ++j) {
+			stream << info.m_keyIDs[j] << "\n";
+		}
+		for (XKBModifierMap::const_iterator j = info.m_goodModifiers.begin();
+								j != info.m_goodModifiers.end(); ++j) {
+			stream << j->first << " " <<
+				static_cast<int>(j->second.m_level) << " " <<
+				j->second.m_mask << " " << (j->second.m_lock ? 1 : 0) << "\n";
+		}
+	}
+	stream.close();
+
+	if (!stream || rename(tmpPath.c_str(), path.c_str()) != 0) {
+		LOG((CLOG_DEBUG1 "can't write %s", path.c_str()));
+		remove(tmpPath.c_str());
+	}
+}
+
+CString
+CXWindowsKeyState::getKeysymMapCachePath()
+{
+	CString path = ARCH->getUserDirectory();
+	if (!path.empty()) {
+		path = ARCH->concatPath(path, s_keysymMapCacheName);
+	}
+	return path;
+}
 #endif
 
 void
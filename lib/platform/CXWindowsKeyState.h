@@ -66,6 +66,14 @@ public:
 	*/
 	void				setAutoRepeat(const XKeyboardState&);
 
+	//! Note changed keycodes
+	/*!
+	Notes that the mapping of keycodes \p first through \p last has
+	changed.  Changes accumulate until the next key map update, which
+	rescans only the changed keycodes when it can.
+	*/
+	void				setKeycodesChanged(int first, int last);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -110,6 +118,11 @@ protected:
 private:
 	void				updateKeysymMap(CKeyMap&);
 	void				updateKeysymMapXKB(CKeyMap&);
+	void				buildKeysymMapXKB(CKeyMap&, int numGroups);
+	UInt64				hashKeyboardXKB() const;
+	bool				loadKeysymMapXKB(UInt64 hash, int numGroups);
+	void				saveKeysymMapXKB(UInt64 hash, int numGroups) const;
+	static CString		getKeysymMapCachePath();
 	bool				hasModifiersXKB() const;
 	int					getEffectiveGroup(KeyCode, int group) const;
 	UInt32				getGroupFromState(unsigned int state) const;
@@ -131,6 +144,31 @@ private:
 	typedef std::map<KeyCode, unsigned int> NonXKBModifierMap;
 	typedef std::map<UInt32, XKBModifierInfo> XKBModifierMap;
 
+	// an X modifier bit that an XKB key can set
+	struct XKBModifierUse {
+	public:
+		int				m_group;
+		int				m_level;
+		UInt32			m_xBit;
+		UInt32			m_modifierBit;
+	};
+	typedef std::vector<XKBModifierUse> XKBModifierUseList;
+
+	// the result of scanning one keycode with XKB.  item masks are X
+	// modifier masks.  m_keyIDs lists the KeyIDs for m_keyCodeFromKey.
+	struct XKBKeycodeInfo {
+	public:
+		bool				m_halfDuplex;
+		CKeyMap::KeyItemList	m_items;
+		XKBModifierUseList	m_modifiers;
+		std::vector<KeyID>	m_keyIDs;
+		XKBModifierMap		m_goodModifiers;
+	};
+	typedef std::vector<XKBKeycodeInfo> XKBKeycodeInfoList;
+
+	void				scanKeycodeXKB(KeyCode, int numGroups,
+							bool useLastGoodModifiers, XKBKeycodeInfo&);
+
 	Display*			m_display;
 #if HAVE_XKB_EXTENSION
 	XkbDescPtr			m_xkb;
@@ -150,6 +188,19 @@ private:
 
 	// autorepeat state
 	XKeyboardState		m_keyboardState;
+
+	// XKB scan results indexed by keycode and the keycode range,
+	// number of groups and VMware hack state they were computed with.
+	// m_xkbNumGroups is -1 if there are no results.
+	XKBKeycodeInfoList	m_xkbKeycodes;
+	int					m_xkbMinKeycode;
+	int					m_xkbNumGroups;
+	bool				m_xkbUsedLastGood;
+
+	// keycodes changed since the last key map update.  none changed if
+	// m_changedFirst > m_changedLast.
+	int					m_changedFirst;
+	int					m_changedLast;
 };
 
 #endif
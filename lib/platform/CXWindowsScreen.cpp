@@ -49,6 +49,12 @@
 #	if HAVE_XKB_EXTENSION
 #		include <X11/XKBlib.h>
 #	endif
+#	if HAVE_X11_EXTENSIONS_XINPUT2_H
+#		include <X11/extensions/XInput2.h>
+#	endif
+#	if HAVE_X11_EXTENSIONS_XFIXES_H
+#		include <X11/extensions/Xfixes.h>
+#	endif
 #endif
 #include "CArch.h"
 
@@ -70,6 +76,15 @@
 
 CXWindowsScreen*		CXWindowsScreen::s_screen = NULL;
 
+// how long to wait for deferred clipboard data before failing the
+// request.  the requesting application is blocked while it waits.
+static const double		s_clipboardRequestTimeout = 5.0;
+
+// how long to wait for more keyboard mapping changes before updating
+// the key map.  layout switchers and xmodmap scripts tend to send a
+// burst of changes.
+static const double		s_keyMapRefreshDelay = 0.1;
+
 CXWindowsScreen::CXWindowsScreen(const char* displayName, bool isPrimary) :
 	m_isPrimary(isPrimary),
 	m_display(NULL),
@@ -87,10 +102,18 @@ CXWindowsScreen::CXWindowsScreen(const char* displayName, bool isPrimary) :
 	m_ic(NULL),
 	m_lastKeycode(0),
 	m_sequenceNumber(0),
+	m_keyMapTimer(NULL),
 	m_screensaver(NULL),
 	m_screensaverNotify(false),
 	m_xtestIsXineramaUnaware(true),
-	m_xkb(false)
+	m_xkb(false),
+	m_xi2(false),
+	m_rawMotion(false),
+	m_xRawMotion(0.0), m_yRawMotion(0.0),
+	m_xfixes(false),
+	m_motionEvents(0),
+	m_motionWarps(0),
+	m_leaveTime(0.0)
 {
 	assert(s_screen == NULL);
 
@@ -132,8 +155,10 @@ CXWindowsScreen::CXWindowsScreen(const char* displayName, bool isPrimary) :
 
 	// initialize the clipboards
 	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-		m_clipboard[id] = new CXWindowsClipboard(m_display, m_window, id);
+		m_clipboard[id]      = new CXWindowsClipboard(m_display, m_window, id);
+		m_clipboardTimer[id] = NULL;
 	}
+	selectSelectionOwnerChanges();
 
 	// install event handlers
 	EVENTQUEUE->adoptHandler(CEvent::kSystem, IEventQueue::getSystemTarget(),
@@ -149,6 +174,10 @@ CXWindowsScreen::~CXWindowsScreen()
 	assert(s_screen  != NULL);
 	assert(m_display != NULL);
 
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		stopClipboardTimer(id);
+	}
+	stopKeyMapTimer();
 	EVENTQUEUE->adoptBuffer(NULL);
 	EVENTQUEUE->removeHandler(CEvent::kSystem, IEventQueue::getSystemTarget());
 	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
@@ -208,6 +237,10 @@ CXWindowsScreen::disable()
 	// keyboard if they're grabbed.
 	XUnmapWindow(m_display, m_window);
 
+	if (m_isPrimary) {
+		stopOffScreenMotion();
+	}
+
 	// restore auto-repeat state
 	if (!m_isPrimary && m_autoRepeat) {
 		XAutoRepeatOn(m_display);
@@ -233,6 +266,10 @@ CXWindowsScreen::enter()
 	// keyboard if they're grabbed.
 	XUnmapWindow(m_display, m_window);
 
+	if (m_isPrimary) {
+		stopOffScreenMotion();
+	}
+
 /* maybe call this if entering for the screensaver
 	// set keyboard focus to root window.  the screensaver should then
 	// pick up key events for when the user enters a password to unlock. 
@@ -305,6 +342,15 @@ CXWindowsScreen::leave()
 		m_filtered.clear();
 	}
 
+	// take motion from raw events if possible.  the warp above still
+	// generates motion events but those are discarded as usual.
+	if (m_isPrimary) {
+		m_motionEvents = 0;
+		m_motionWarps  = 0;
+		m_leaveTime    = ARCH->time();
+		selectRawMotion(true);
+	}
+
 	// now off screen
 	m_isOnScreen = false;
 
@@ -323,9 +369,10 @@ CXWindowsScreen::setClipboard(ClipboardID id, const IClipboard* clipboard)
 	Time timestamp = CXWindowsUtil::getCurrentTime(
 								m_display, m_clipboard[id]->getWindow());
 
+	bool result = true;
 	if (clipboard != NULL) {
 		// save clipboard data
-		return CClipboard::copy(m_clipboard[id], clipboard, timestamp);
+		result = CClipboard::copy(m_clipboard[id], clipboard, timestamp);
 	}
 	else {
 		// assert clipboard ownership
@@ -334,8 +381,13 @@ CXWindowsScreen::setClipboard(ClipboardID id, const IClipboard* clipboard)
 		}
 		m_clipboard[id]->empty();
 		m_clipboard[id]->close();
-		return true;
 	}
+
+	// stop waiting if the new data answered the waiting requests
+	if (!m_clipboard[id]->hasDeferredRequests()) {
+		stopClipboardTimer(id);
+	}
+	return result;
 }
 
 void
@@ -425,6 +477,25 @@ CXWindowsScreen::getClipboard(ClipboardID id, IClipboard* clipboard) const
 	return CClipboard::copy(clipboard, m_clipboard[id], timestamp);
 }
 
+bool
+CXWindowsScreen::getClipboardFormats(ClipboardID id,
+				IClipboard* clipboard, UInt32 formats) const
+{
+	assert(clipboard != NULL);
+
+	// fail if we don't have the requested clipboard
+	if (m_clipboard[id] == NULL) {
+		return false;
+	}
+
+	// get the actual time.  ICCCM does not allow CurrentTime.
+	Time timestamp = CXWindowsUtil::getCurrentTime(
+								m_display, m_clipboard[id]->getWindow());
+
+	// copy just the wanted formats
+	return m_clipboard[id]->getFormats(clipboard, formats, timestamp);
+}
+
 void
 CXWindowsScreen::getShape(SInt32& x, SInt32& y, SInt32& w, SInt32& h) const
 {
@@ -749,11 +820,14 @@ CXWindowsScreen::getCursorCenter(SInt32& x, SInt32& y) const
 void
 CXWindowsScreen::fakeMouseButton(ButtonID button, bool press) const
 {
+	// note -- we don't flush faked input.  CXWindowsEventQueueBuffer
+	// flushes when we get back to the event loop so all the input
+	// faked for a batch of messages from the server goes out in one
+	// write.
 	const unsigned int xButton = mapButtonToX(button);
 	if (xButton != 0) {
 		XTestFakeButtonEvent(m_display, xButton,
 							press ? True : False, CurrentTime);
-		XFlush(m_display);
 	}
 }
 
@@ -767,7 +841,6 @@ CXWindowsScreen::fakeMouseMove(SInt32 x, SInt32 y) const
 		XTestFakeMotionEvent(m_display, DefaultScreen(m_display),
 							x, y, CurrentTime);
 	}
-	XFlush(m_display);
 }
 
 void
@@ -780,7 +853,6 @@ CXWindowsScreen::fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const
 	else {
 		XTestFakeRelativeMotionEvent(m_display, dx, dy, CurrentTime);
 	}
-	XFlush(m_display);
 }
 
 void
@@ -822,7 +894,6 @@ CXWindowsScreen::fakeMouseWheel(SInt32, SInt32 yDelta) const
 		XTestFakeButtonEvent(m_display, xButton, True, CurrentTime);
 		XTestFakeButtonEvent(m_display, xButton, False, CurrentTime);
 	}
-	XFlush(m_display);
 }
 
 Display*
@@ -873,6 +944,39 @@ CXWindowsScreen::openDisplay(const char* displayName)
 	}
 #endif
 
+#if HAVE_X11_EXTENSIONS_XINPUT2_H
+	// check for XInput2 raw events on the primary screen.  we need
+	// version 2.1 or later since earlier versions don't report raw
+	// events while the pointer is grabbed.
+	m_xi2 = false;
+	if (m_isPrimary) {
+		int firstEvent, firstError;
+		if (XQueryExtension(display, "XInputExtension",
+							&m_xi2Opcode, &firstEvent, &firstError)) {
+			int major = 2, minor = 1;
+			if (XIQueryVersion(display, &major, &minor) == Success &&
+				(major > 2 || (major == 2 && minor >= 1))) {
+				LOG((CLOG_DEBUG "using XInput %d.%d raw motion", major, minor));
+				m_xi2 = true;
+			}
+		}
+	}
+#endif
+
+#if HAVE_X11_EXTENSIONS_XFIXES_H
+	// check for XFixes selection ownership notification
+	m_xfixes = false;
+	{
+		int errorBase;
+		if (XFixesQueryExtension(display, &m_xfixesEventBase, &errorBase)) {
+			int major, minor;
+			XFixesQueryVersion(display, &major, &minor);
+			LOG((CLOG_DEBUG "using XFixes %d.%d selection notification", major, minor));
+			m_xfixes = true;
+		}
+	}
+#endif
+
 	return display;
 }
 
@@ -1181,11 +1285,15 @@ CXWindowsScreen::handleSystemEvent(const CEvent& event, void*)
 			// we just lost the selection.  that means someone else
 			// grabbed the selection so this screen is now the
 			// selection owner.  report that to the receiver.
+			// if XFixes is reporting ownership changes then the
+			// grab is reported when that notification arrives.
 			ClipboardID id = getClipboardID(xevent->xselectionclear.selection);
 			if (id != kClipboardEnd) {
 				LOG((CLOG_DEBUG "lost clipboard %d ownership at time %d", id, xevent->xselectionclear.time));
 				m_clipboard[id]->lost(xevent->xselectionclear.time);
-				sendClipboardEvent(getClipboardGrabbedEvent(), id);
+				if (!m_xfixes) {
+					sendClipboardEvent(getClipboardGrabbedEvent(), id);
+				}
 				return;
 			}
 		}
@@ -1215,6 +1323,7 @@ CXWindowsScreen::handleSystemEvent(const CEvent& event, void*)
 								xevent->xselectionrequest.target,
 								xevent->xselectionrequest.time,
 								xevent->xselectionrequest.property);
+				requestClipboard(id);
 				return;
 			}
 		}
@@ -1266,6 +1375,20 @@ CXWindowsScreen::handleSystemEvent(const CEvent& event, void*)
 		return;
 
 	default:
+#if HAVE_X11_EXTENSIONS_XFIXES_H
+		if (m_xfixes &&
+			xevent->type == m_xfixesEventBase + XFixesSelectionNotify) {
+			onSelectionOwnerChange(xevent);
+			return;
+		}
+#endif
+#if HAVE_X11_EXTENSIONS_XINPUT2_H
+		if (m_xi2 && xevent->type == GenericEvent &&
+			xevent->xcookie.extension == m_xi2Opcode) {
+			onRawMotion(xevent);
+			return;
+		}
+#endif
 #if HAVE_XKB_EXTENSION
 		if (m_xkb && xevent->type == m_xkbEventBase) {
 			XkbEvent* xkbEvent = reinterpret_cast<XkbEvent*>(xevent);
@@ -1452,6 +1575,10 @@ CXWindowsScreen::onMouseMove(const XMotionEvent& xmotion)
 		sendEvent(getMotionOnPrimaryEvent(),
 							CMotionInfo::alloc(m_xCursor, m_yCursor));
 	}
+	else if (m_rawMotion) {
+		// motion on secondary screen is reported by onRawMotion().
+		// the cursor is free to wander since it's hidden and grabbed.
+	}
 	else {
 		// motion on secondary screen.  warp mouse back to
 		// center.
@@ -1471,6 +1598,7 @@ CXWindowsScreen::onMouseMove(const XMotionEvent& xmotion)
 			xmotion.y_root - m_yCenter < -s_size ||
 			xmotion.y_root - m_yCenter >  s_size) {
 			warpCursorNoFlush(m_xCenter, m_yCenter);
+			++m_motionWarps;
 		}
 
 		// send event if mouse moved.  do this after warping
@@ -1481,10 +1609,84 @@ CXWindowsScreen::onMouseMove(const XMotionEvent& xmotion)
 		// effectively overriding it.
 		if (x != 0 || y != 0) {
 			sendEvent(getMotionOnSecondaryEvent(), CMotionInfo::alloc(x, y));
+			++m_motionEvents;
 		}
 	}
 }
 
+void
+CXWindowsScreen::onRawMotion(XEvent* xevent)
+{
+#if HAVE_X11_EXTENSIONS_XINPUT2_H
+	XGenericEventCookie* cookie = &xevent->xcookie;
+	if (!XGetEventData(m_display, cookie)) {
+		return;
+	}
+
+	const XIRawEvent* raw = reinterpret_cast<const XIRawEvent*>(cookie->data);
+	if (cookie->evtype == XI_RawMotion && m_rawMotion && !m_isOnScreen &&
+		m_relativePointers.count(raw->sourceid) > 0) {
+		// the event has values only for the valuators in the mask.
+		// valuators 0 and 1 are x and y.  use the accelerated values
+		// so motion feels the same as it does locally.
+		const double* value = raw->valuators.values;
+		double dx = 0.0, dy = 0.0;
+		if (raw->valuators.mask_len > 0) {
+			if (XIMaskIsSet(raw->valuators.mask, 0)) {
+				dx = *value++;
+			}
+			if (XIMaskIsSet(raw->valuators.mask, 1)) {
+				dy = *value++;
+			}
+		}
+
+		// report whole pixels and keep the fraction for next time so
+		// slow motion isn't lost
+		m_xRawMotion += dx;
+		m_yRawMotion += dy;
+		SInt32 x      = static_cast<SInt32>(m_xRawMotion);
+		SInt32 y      = static_cast<SInt32>(m_yRawMotion);
+		m_xRawMotion -= x;
+		m_yRawMotion -= y;
+		LOG((CLOG_DEBUG2 "event: XI_RawMotion %+f,%+f from device %d", dx, dy, raw->sourceid));
+		if (x != 0 || y != 0) {
+			sendEvent(getMotionOnSecondaryEvent(), CMotionInfo::alloc(x, y));
+			++m_motionEvents;
+		}
+	}
+
+	XFreeEventData(m_display, cookie);
+#endif
+}
+
+void
+CXWindowsScreen::onSelectionOwnerChange(XEvent* xevent)
+{
+#if HAVE_X11_EXTENSIONS_XFIXES_H
+	const XFixesSelectionNotifyEvent* xfixes =
+		reinterpret_cast<const XFixesSelectionNotifyEvent*>(xevent);
+	ClipboardID id = getClipboardID(xfixes->selection);
+	if (id == kClipboardEnd) {
+		return;
+	}
+
+	// ignore ourself taking ownership.  also ignore the selection
+	// being released (e.g. deselecting text drops PRIMARY);  there's
+	// nothing to share and the other screens keep their clipboard.
+	// otherwise some other client now owns the selection, even if we
+	// didn't own it before, so this screen is now the clipboard owner.
+	// report that to the receiver.  the data isn't fetched until it's
+	// asked for.
+	if (xfixes->owner == None ||
+		xfixes->owner == m_clipboard[id]->getWindow()) {
+		return;
+	}
+	LOG((CLOG_DEBUG "clipboard %d owner changed to 0x%08x at time %d", id, xfixes->owner, xfixes->selection_timestamp));
+	m_clipboard[id]->lost(xfixes->selection_timestamp);
+	sendClipboardEvent(getClipboardGrabbedEvent(), id);
+#endif
+}
+
 Cursor
 CXWindowsScreen::createBlankCursor() const
 {
@@ -1558,6 +1760,46 @@ CXWindowsScreen::destroyClipboardRequest(Window requestor)
 	}
 }
 
+void
+CXWindowsScreen::requestClipboard(ClipboardID id)
+{
+	// ask once.  the same request answers every waiting request.
+	if (m_clipboardTimer[id] != NULL ||
+		!m_clipboard[id]->hasDeferredRequests()) {
+		return;
+	}
+	LOG((CLOG_DEBUG "requesting deferred clipboard %d data", id));
+	m_clipboardTimer[id] =
+		EVENTQUEUE->newOneShotTimer(s_clipboardRequestTimeout, NULL);
+	EVENTQUEUE->adoptHandler(CEvent::kTimer, m_clipboardTimer[id],
+							new TMethodEventJob<CXWindowsScreen>(this,
+								&CXWindowsScreen::handleClipboardTimer));
+	sendClipboardEvent(getClipboardRequestedEvent(), id);
+}
+
+void
+CXWindowsScreen::stopClipboardTimer(ClipboardID id)
+{
+	if (m_clipboardTimer[id] != NULL) {
+		EVENTQUEUE->removeHandler(CEvent::kTimer, m_clipboardTimer[id]);
+		EVENTQUEUE->deleteTimer(m_clipboardTimer[id]);
+		m_clipboardTimer[id] = NULL;
+	}
+}
+
+void
+CXWindowsScreen::handleClipboardTimer(const CEvent& event, void*)
+{
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		if (m_clipboardTimer[id] == event.getTarget()) {
+			LOG((CLOG_WARN "timed out waiting for clipboard %d data", id));
+			stopClipboardTimer(id);
+			m_clipboard[id]->failDeferredRequests();
+			break;
+		}
+	}
+}
+
 void
 CXWindowsScreen::onError()
 {
@@ -1774,6 +2016,96 @@ CXWindowsScreen::warpCursorNoFlush(SInt32 x, SInt32 y)
 	LOG((CLOG_DEBUG2 "warped to %d,%d", x, y));
 }
 
+void
+CXWindowsScreen::stopOffScreenMotion()
+{
+	// stop taking motion from raw events
+	const bool rawMotion = m_rawMotion;
+	selectRawMotion(false);
+
+	// report how much work off screen motion took.  each warp is a
+	// round trip to the X server.  there's nothing to report if we
+	// never left.
+	if (!m_isOnScreen) {
+		const double time = ARCH->time() - m_leaveTime;
+		LOG((CLOG_DEBUG1 "off screen for %.1fs:  %d motion events (%.0f/s), %d warps, %s", time, m_motionEvents, (time > 0.0) ? m_motionEvents / time : 0.0, m_motionWarps, rawMotion ? "raw motion" : "warp motion"));
+	}
+}
+
+void
+CXWindowsScreen::selectRawMotion(bool enable)
+{
+#if HAVE_X11_EXTENSIONS_XINPUT2_H
+	if (!m_xi2 || enable == m_rawMotion) {
+		return;
+	}
+
+	// find the relative pointing devices.  absolute devices, like
+	// tablets and touchscreens, report positions rather than motion
+	// in their raw events so we ignore them.  we check each time in
+	// case devices have come or gone.
+	if (enable) {
+		m_relativePointers.clear();
+		int numDevices;
+		XIDeviceInfo* devices = XIQueryDevice(m_display,
+								XIAllDevices, &numDevices);
+		for (int i = 0; i < numDevices; ++i) {
+			if (devices[i].use != XISlavePointer) {
+				continue;
+			}
+			for (int j = 0; j < devices[i].num_classes; ++j) {
+				const XIAnyClassInfo* info = devices[i].classes[j];
+				if (info->type == XIValuatorClass) {
+					const XIValuatorClassInfo* valuator =
+						reinterpret_cast<const XIValuatorClassInfo*>(info);
+					if (valuator->number == 0 &&
+						valuator->mode == XIModeRelative) {
+						m_relativePointers.insert(devices[i].deviceid);
+					}
+				}
+			}
+		}
+		XIFreeDeviceInfo(devices);
+		if (m_relativePointers.empty()) {
+			LOG((CLOG_DEBUG1 "no relative pointers for raw motion"));
+			return;
+		}
+	}
+
+	unsigned char bits[XIMaskLen(XI_RawMotion)];
+	memset(bits, 0, sizeof(bits));
+	if (enable) {
+		XISetMask(bits, XI_RawMotion);
+	}
+	XIEventMask mask;
+	mask.deviceid = XIAllMasterDevices;
+	mask.mask_len = sizeof(bits);
+	mask.mask     = bits;
+	XISelectEvents(m_display, m_root, &mask, 1);
+
+	m_rawMotion  = enable;
+	m_xRawMotion = 0.0;
+	m_yRawMotion = 0.0;
+#else
+	(void)enable;
+#endif
+}
+
+void
+CXWindowsScreen::selectSelectionOwnerChanges()
+{
+#if HAVE_X11_EXTENSIONS_XFIXES_H
+	if (!m_xfixes) {
+		return;
+	}
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		XFixesSelectSelectionInput(m_display, m_window,
+								m_clipboard[id]->getSelection(),
+								XFixesSetSelectionOwnerNotifyMask);
+	}
+#endif
+}
+
 void
 CXWindowsScreen::updateButtons()
 {
@@ -1856,27 +2188,84 @@ CXWindowsScreen::grabMouseAndKeyboard()
 void
 CXWindowsScreen::refreshKeyboard(XEvent* event)
 {
-	if (XPending(m_display) > 0) {
-		XEvent tmpEvent;
-		XPeekEvent(m_display, &tmpEvent);
-		if (tmpEvent.type == MappingNotify) {
-			// discard this event since another follows.
-			// we tend to get a bunch of these in a row.
-			return;
-		}
-	}
-
-	// keyboard mapping changed
+	// update Xlib's copy of the mapping and note the changed keycodes
 #if HAVE_XKB_EXTENSION
 	if (m_xkb && event->type == m_xkbEventBase) {
-		XkbRefreshKeyboardMapping((XkbMapNotifyEvent*)event);
+		XkbMapNotifyEvent* xkbEvent = (XkbMapNotifyEvent*)event;
+		XkbRefreshKeyboardMapping(xkbEvent);
+
+		// changes to anything other than these affect every keycode
+		static const unsigned int s_perKeyChanges =
+			XkbKeySymsMask | XkbKeyActionsMask |
+			XkbKeyBehaviorsMask | XkbModifierMapMask;
+		if ((xkbEvent->changed & ~s_perKeyChanges) != 0) {
+			m_keyState->setKeycodesChanged(0, 255);
+		}
+		else {
+			if ((xkbEvent->changed & XkbKeySymsMask) != 0) {
+				m_keyState->setKeycodesChanged(xkbEvent->first_key_sym,
+								xkbEvent->first_key_sym +
+								xkbEvent->num_key_syms - 1);
+			}
+			if ((xkbEvent->changed & XkbKeyActionsMask) != 0) {
+				m_keyState->setKeycodesChanged(xkbEvent->first_key_act,
+								xkbEvent->first_key_act +
+								xkbEvent->num_key_acts - 1);
+			}
+			if ((xkbEvent->changed & XkbKeyBehaviorsMask) != 0) {
+				m_keyState->setKeycodesChanged(xkbEvent->first_key_behavior,
+								xkbEvent->first_key_behavior +
+								xkbEvent->num_key_behaviors - 1);
+			}
+			if ((xkbEvent->changed & XkbModifierMapMask) != 0) {
+				m_keyState->setKeycodesChanged(xkbEvent->first_modmap_key,
+								xkbEvent->first_modmap_key +
+								xkbEvent->num_modmap_keys - 1);
+			}
+		}
 	}
 	else
-#else
+#endif
 	{
-		XRefreshKeyboardMapping(&event->xmapping);
+		XMappingEvent* mapEvent = &event->xmapping;
+		if (mapEvent->request == MappingPointer) {
+			// doesn't affect the keyboard
+			return;
+		}
+		XRefreshKeyboardMapping(mapEvent);
+		if (mapEvent->request == MappingKeyboard) {
+			m_keyState->setKeycodesChanged(mapEvent->first_keycode,
+								mapEvent->first_keycode +
+								mapEvent->count - 1);
+		}
+		else {
+			m_keyState->setKeycodesChanged(0, 255);
+		}
 	}
-#endif
+
+	// update the key map once the changes stop coming
+	stopKeyMapTimer();
+	m_keyMapTimer = EVENTQUEUE->newOneShotTimer(s_keyMapRefreshDelay, NULL);
+	EVENTQUEUE->adoptHandler(CEvent::kTimer, m_keyMapTimer,
+							new TMethodEventJob<CXWindowsScreen>(this,
+								&CXWindowsScreen::handleKeyMapTimer));
+}
+
+void
+CXWindowsScreen::stopKeyMapTimer()
+{
+	if (m_keyMapTimer != NULL) {
+		EVENTQUEUE->removeHandler(CEvent::kTimer, m_keyMapTimer);
+		EVENTQUEUE->deleteTimer(m_keyMapTimer);
+		m_keyMapTimer = NULL;
+	}
+}
+
+void
+CXWindowsScreen::handleKeyMapTimer(const CEvent&, void*)
+{
+	stopKeyMapTimer();
+	LOG((CLOG_DEBUG1 "keyboard mapping changed"));
 	m_keyState->updateKeyMap();
 	m_keyState->updateKeyState();
 }
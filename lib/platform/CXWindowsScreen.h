@@ -24,6 +24,7 @@
 #	include <X11/Xlib.h>
 #endif
 
+class CEventQueueTimer;
 class CXWindowsClipboard;
 class CXWindowsKeyState;
 class CXWindowsScreenSaver;
@@ -77,6 +78,8 @@ public:
 	virtual void		setOptions(const COptionsList& options);
 	virtual void		setSequenceNumber(UInt32);
 	virtual bool		isPrimary() const;
+	virtual bool		getClipboardFormats(ClipboardID, IClipboard*,
+							UInt32 formats) const;
 
 protected:
 	// IPlatformScreen overrides
@@ -103,6 +106,12 @@ private:
 	// terminate a selection request
 	void				destroyClipboardRequest(Window window);
 
+	// ask for deferred clipboard data if a selection request is
+	// waiting for it and give up if it doesn't arrive soon enough
+	void				requestClipboard(ClipboardID);
+	void				stopClipboardTimer(ClipboardID);
+	void				handleClipboardTimer(const CEvent&, void*);
+
 	// X I/O error handler
 	void				onError();
 	static int			ioErrorHandler(Display*);
@@ -128,6 +137,8 @@ private:
 	void				onMousePress(const XButtonEvent&);
 	void				onMouseRelease(const XButtonEvent&);
 	void				onMouseMove(const XMotionEvent&);
+	void				onRawMotion(XEvent*);
+	void				onSelectionOwnerChange(XEvent*);
 
 	void				selectEvents(Window) const;
 	void				doSelectEvents(Window) const;
@@ -138,7 +149,20 @@ private:
 
 	void				warpCursorNoFlush(SInt32 x, SInt32 y);
 
+	// select or deselect XInput2 raw motion events
+	void				selectRawMotion(bool enable);
+
+	// stop off screen motion on the primary screen and report on it
+	void				stopOffScreenMotion();
+
+	// ask XFixes to report clipboard selection ownership changes
+	void				selectSelectionOwnerChanges();
+
+	// note a keyboard mapping change and update the key map once the
+	// burst of changes it's part of is over
 	void				refreshKeyboard(XEvent*);
+	void				stopKeyMapTimer();
+	void				handleKeyMapTimer(const CEvent&, void*);
 
 	static Bool			findKeyEvent(Display*, XEvent* xevent, XPointer arg);
 
@@ -195,10 +219,15 @@ private:
 	KeyCode				m_lastKeycode;
 	CFilteredKeycodes	m_filtered;
 
-	// clipboards
+	// clipboards.  m_clipboardTimer is non-NULL while waiting for
+	// deferred data.
 	CXWindowsClipboard*	m_clipboard[kClipboardEnd];
+	CEventQueueTimer*	m_clipboardTimer[kClipboardEnd];
 	UInt32				m_sequenceNumber;
 
+	// non-NULL while waiting for keyboard mapping changes to stop
+	CEventQueueTimer*	m_keyMapTimer;
+
 	// screen saver stuff
 	CXWindowsScreenSaver*	m_screensaver;
 	bool				m_screensaverNotify;
@@ -221,6 +250,27 @@ private:
 	bool				m_xkb;
 	int					m_xkbEventBase;
 
+	// XInput2 extension stuff.  while off screen, if m_rawMotion is
+	// true, motion is taken from raw events from the relative pointer
+	// devices in m_relativePointers instead of by warping the cursor
+	// back to the center.  m_xRawMotion and m_yRawMotion hold the
+	// fraction of a pixel not yet reported.
+	bool				m_xi2;
+	int					m_xi2Opcode;
+	bool				m_rawMotion;
+	std::set<int>		m_relativePointers;
+	double				m_xRawMotion, m_yRawMotion;
+
+	// XFixes extension stuff.  if m_xfixes is true we're told whenever
+	// any client takes ownership of a clipboard selection.
+	bool				m_xfixes;
+	int					m_xfixesEventBase;
+
+	// off screen motion statistics
+	UInt32				m_motionEvents;
+	UInt32				m_motionWarps;
+	double				m_leaveTime;
+
 	// pointer to (singleton) screen.  this is only needed by
 	// ioErrorHandler().
 	static CXWindowsScreen*	s_screen;
@@ -18,6 +18,7 @@
 #include "CLog.h"
 #include "CStringUtil.h"
 #include <X11/Xatom.h>
+#include <algorithm>
 #define XK_APL
 #define XK_ARABIC
 #define XK_ARMENIAN
@@ -73,7 +74,9 @@
 struct codepair {
 	KeySym				keysym;
 	UInt32				ucs4;
-} s_keymap[] = {
+};
+
+static codepair s_keymap[] = {
 { XK_Aogonek,                     0x0104 }, /* LATIN CAPITAL LETTER A WITH OGONEK */
 { XK_breve,                       0x02d8 }, /* BREVE */
 { XK_Lstroke,                     0x0141 }, /* LATIN CAPITAL LETTER L WITH STROKE */
@@ -1241,6 +1244,17 @@ XK_Uhorn
 XK_uhorn
 */
 
+static const size_t		s_keymapSize = sizeof(s_keymap) / sizeof(s_keymap[0]);
+
+// orders s_keymap by keysym.  the table isn't in keysym order and which
+// entries it has depends on the keysym headers so it's sorted at runtime.
+static
+bool
+codepairLess(const codepair& a, const codepair& b)
+{
+	return (a.keysym < b.keysym);
+}
+
 // map "Internet" keys to KeyIDs
 static const KeySym s_map1008FF[] =
 {
@@ -1284,7 +1298,7 @@ static const KeySym s_map1008FF[] =
 // CXWindowsUtil
 //
 
-CXWindowsUtil::CKeySymMap	CXWindowsUtil::s_keySymToUCS4;
+bool					CXWindowsUtil::s_keyMapSorted = false;
 
 bool
 CXWindowsUtil::getWindowProperty(Display* display, Window window,
@@ -1301,9 +1315,10 @@ CXWindowsUtil::getWindowProperty(Display* display, Window window,
 
 	// read the property
 	bool okay = true;
-	const long length = XMaxRequestSize(display);
+	const long length = getMaxPropertySize(display) / 4;
 	long offset = 0;
 	unsigned long bytesLeft = 1;
+	bool first = true;
 	while (bytesLeft != 0) {
 		// get more data
 		unsigned long numItems;
@@ -1338,8 +1353,12 @@ CXWindowsUtil::getWindowProperty(Display* display, Window window,
 			break;
 		}
 
-		// append data
+		// append data.  if there's more to come then make room for
+		// all of it now rather than growing the string chunk by chunk.
 		if (data != NULL) {
+			if (first && bytesLeft != 0) {
+				data->reserve(data->size() + numBytes + bytesLeft);
+			}
 			data->append((char*)rawData, numBytes);
 		}
 		else {
@@ -1349,6 +1368,7 @@ CXWindowsUtil::getWindowProperty(Display* display, Window window,
 
 		// done with returned data
 		XFree(rawData);
+		first = false;
 	}
 
 	// delete the property if requested
@@ -1379,7 +1399,7 @@ CXWindowsUtil::setWindowProperty(Display* display, Window window,
 				Atom property, const void* vdata, UInt32 size,
 				Atom type, SInt32 format)
 {
-	const UInt32 length       = 4 * XMaxRequestSize(display);
+	const UInt32 length       = getMaxPropertySize(display);
 	const unsigned char* data = reinterpret_cast<const unsigned char*>(vdata);
 	const UInt32 datumSize    = static_cast<UInt32>(format / 8);
 
@@ -1416,6 +1436,21 @@ CXWindowsUtil::setWindowProperty(Display* display, Window window,
 	return !error;
 }
 
+UInt32
+CXWindowsUtil::getMaxPropertySize(Display* display)
+{
+	// the request sizes are in 4 byte units.  XExtendedMaxRequestSize()
+	// returns 0 if the server doesn't support BIG-REQUESTS.
+	long size = XExtendedMaxRequestSize(display);
+	if (size == 0) {
+		size = XMaxRequestSize(display);
+	}
+
+	// leave room for the ChangeProperty request header, including the
+	// extra length field BIG-REQUESTS adds
+	return static_cast<UInt32>(4 * (size - 8));
+}
+
 Time
 CXWindowsUtil::getCurrentTime(Display* display, Window window)
 {
@@ -1531,9 +1566,13 @@ CXWindowsUtil::mapKeySymToKeyID(KeySym k)
 
 	default: {
 		// lookup character in table
-		CKeySymMap::const_iterator index = s_keySymToUCS4.find(k);
-		if (index != s_keySymToUCS4.end()) {
-			return static_cast<KeyID>(index->second);
+		const codepair* begin = s_keymap;
+		const codepair* end   = s_keymap + s_keymapSize;
+		codepair key          = { k, 0 };
+		const codepair* index = std::lower_bound(begin, end, key,
+								&codepairLess);
+		if (index != end && index->keysym == k) {
+			return static_cast<KeyID>(index->ucs4);
 		}
 
 		// unknown character
@@ -1681,10 +1720,10 @@ CXWindowsUtil::propertyNotifyPredicate(Display*, XEvent* xevent, XPointer arg)
 void
 CXWindowsUtil::initKeyMaps()
 {
-	if (s_keySymToUCS4.empty()) {
-		for (size_t i =0; i < sizeof(s_keymap) / sizeof(s_keymap[0]); ++i) {
-			s_keySymToUCS4[s_keymap[i].keysym] = s_keymap[i].ucs4;
-		}
+	// sort the table once so lookups can binary search it in place
+	if (!s_keyMapSorted) {
+		std::sort(s_keymap, s_keymap + s_keymapSize, &codepairLess);
+		s_keyMapSorted = true;
 	}
 }
 
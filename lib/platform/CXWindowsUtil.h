@@ -17,7 +17,6 @@
 
 #include "CString.h"
 #include "BasicTypes.h"
-#include "stdmap.h"
 #include "stdvector.h"
 #if X_DISPLAY_MISSING
 #	error X11 is required to build synergy
@@ -53,6 +52,14 @@ public:
 							const void* data, UInt32 size,
 							Atom type, SInt32 format);
 
+	//! Get maximum property data size
+	/*!
+	Returns the number of bytes of property data that fit in a single
+	request.  This uses the BIG-REQUESTS limit when the server supports
+	it.  The result is a multiple of 4.
+	*/
+	static UInt32		getMaxPropertySize(Display*);
+
 	//! Get X server time
 	/*!
 	Returns the current X server time.
@@ -177,9 +184,7 @@ private:
 	static void			initKeyMaps();
 
 private:
-	typedef std::map<KeySym, UInt32> CKeySymMap;
-
-	static CKeySymMap	s_keySymToUCS4;
+	static bool			s_keyMapSorted;
 };
 
 #endif
@@ -38,6 +38,12 @@ CBaseClientProxy::setJumpCursorPos(SInt32 x, SInt32 y)
 	m_y = y;
 }
 
+void
+CBaseClientProxy::requestClipboard(ClipboardID)
+{
+	// do nothing
+}
+
 void
 CBaseClientProxy::getJumpCursorPos(SInt32& x, SInt32& y) const
 {
@@ -36,6 +36,15 @@ public:
 	*/
 	void				setJumpCursorPos(SInt32 x, SInt32 y);
 
+	//! Request deferred clipboard data
+	/*!
+	Ask the client for the data it deferred (see
+	IClipboard::addDeferred()) in the clipboard it most recently sent.
+	The complete clipboard arrives like any other clipboard change.
+	The default does nothing.
+	*/
+	virtual void		requestClipboard(ClipboardID);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -16,6 +16,7 @@
 #include "CClientProxy.h"
 #include "CClientProxyUnknown.h"
 #include "CPacketStreamFilter.h"
+#include "CPriorityStreamFilter.h"
 #include "IStreamFilterFactory.h"
 #include "IDataSocket.h"
 #include "IListenSocket.h"
@@ -126,11 +127,13 @@ CClientListener::handleClientConnecting(const CEvent&, void*)
 	}
 	LOG((CLOG_NOTE "accepted client connection"));
 
-	// filter socket messages, including a packetizing filter
+	// filter socket messages, including a packetizing filter and a
+	// filter to keep bulk data from delaying input events
 	if (m_streamFilterFactory != NULL) {
 		stream = m_streamFilterFactory->create(stream, true);
 	}
 	stream = new CPacketStreamFilter(stream, true);
+	stream = new CPriorityStreamFilter(stream, true);
 
 	// create proxy for unknown client
 	CClientProxyUnknown* client = new CClientProxyUnknown(stream, 30.0);
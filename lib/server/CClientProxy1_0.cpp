@@ -273,10 +273,7 @@ CClientProxy1_0::setClipboard(ClipboardID id, const IClipboard* clipboard)
 		// this clipboard is now clean
 		m_clipboard[id].m_dirty = false;
 		CClipboard::copy(&m_clipboard[id].m_clipboard, clipboard);
-
-		CString data = m_clipboard[id].m_clipboard.marshall();
-		LOG((CLOG_DEBUG "send clipboard %d to \"%s\" size=%d", id, getName().c_str(), data.size()));
-		CProtocolUtil::writef(getStream(), kMsgDClipboard, id, 0, &data);
+		sendClipboard(id, m_clipboard[id].m_clipboard);
 	}
 }
 
@@ -445,7 +442,27 @@ CClientProxy1_0::recvClipboard()
 	}
 
 	// save clipboard
-	m_clipboard[id].m_clipboard.unmarshall(data, 0);
+	CClipboard clipboard;
+	clipboard.unmarshall(data, 0);
+	updateClipboard(id, seqNum, &clipboard);
+
+	return true;
+}
+
+void
+CClientProxy1_0::sendClipboard(ClipboardID id, const CClipboard& clipboard)
+{
+	CString data = clipboard.marshall();
+	LOG((CLOG_DEBUG "send clipboard %d to \"%s\" size=%d", id, getName().c_str(), data.size()));
+	CProtocolUtil::writef(getStream(), kMsgDClipboard, id, 0, &data);
+}
+
+void
+CClientProxy1_0::updateClipboard(ClipboardID id, UInt32 seqNum,
+				const IClipboard* clipboard)
+{
+	// save clipboard
+	CClipboard::copy(&m_clipboard[id].m_clipboard, clipboard);
 	m_clipboard[id].m_sequenceNumber = seqNum;
 
 	// notify
@@ -454,8 +471,6 @@ CClientProxy1_0::recvClipboard()
 	info->m_sequenceNumber = seqNum;
 	EVENTQUEUE->addEvent(CEvent(getClipboardChangedEvent(),
 							getEventTarget(), info));
-
-	return true;
 }
 
 bool
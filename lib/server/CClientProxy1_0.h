@@ -65,6 +65,13 @@ protected:
 	virtual void		addHeartbeatTimer();
 	virtual void		removeHeartbeatTimer();
 
+	// send the clipboard to the client
+	virtual void		sendClipboard(ClipboardID, const CClipboard&);
+
+	// save the client's new clipboard and notify the server
+	void				updateClipboard(ClipboardID, UInt32 seqNum,
+							const IClipboard*);
+
 private:
 	void				disconnect();
 	void				removeHandlers();
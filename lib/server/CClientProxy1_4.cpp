@@ -0,0 +1,224 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "CClientProxy1_4.h"
+#include "CClipboard.h"
+#include "CProtocolUtil.h"
+#include "CLog.h"
+#include <cstring>
+
+//
+// CClientProxy1_4
+//
+
+CClientProxy1_4::CClientProxy1_4(const CString& name, IStream* stream) :
+	CClientProxy1_3(name, stream),
+	m_cache(kClipboardCacheEntries, kClipboardCacheSize),
+	m_transfer(getStream())
+{
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		m_recvSeqNum[id]  = 0;
+		m_recvQueried[id] = false;
+	}
+}
+
+CClientProxy1_4::~CClientProxy1_4()
+{
+	// do nothing
+}
+
+void
+CClientProxy1_4::requestClipboard(ClipboardID id)
+{
+	// ignore if we're not waiting on formats or we've already asked
+	CClipboardOffer& offer = m_recvOffer[id];
+	if (!offer.isValid() || m_recvQueried[id]) {
+		return;
+	}
+
+	// ask for what's still missing
+	CClipboardOffer::CFormatList missing;
+	if (!offer.resolve(m_cache, &missing)) {
+		LOG((CLOG_DEBUG "query client \"%s\" for %d clipboard %d formats", getName().c_str(), missing.size(), id));
+		CProtocolUtil::writef(getStream(), kMsgQClipboard, id, &missing);
+		m_recvQueried[id] = true;
+		return;
+	}
+
+	// the cache got the missing data since the offer arrived
+	CClipboard clipboard;
+	offer.get(&clipboard, 0);
+	offer.clear();
+	updateClipboard(id, m_recvSeqNum[id], &clipboard);
+}
+
+void
+CClientProxy1_4::grabClipboard(ClipboardID id)
+{
+	// any clipboard data we're still sending is out of date
+	m_transfer.cancel(id);
+	CClientProxy1_3::grabClipboard(id);
+}
+
+bool
+CClientProxy1_4::parseMessage(const UInt8* code)
+{
+	if (memcmp(code, kMsgDClipboardOffer, 4) == 0) {
+		return recvClipboardOffer();
+	}
+	else if (memcmp(code, kMsgDClipboardFormats, 4) == 0) {
+		return recvClipboardFormats();
+	}
+	else if (memcmp(code, kMsgQClipboard, 4) == 0) {
+		return recvClipboardQuery();
+	}
+	else {
+		return CClientProxy1_3::parseMessage(code);
+	}
+}
+
+void
+CClientProxy1_4::sendClipboard(ClipboardID id, const CClipboard& clipboard)
+{
+	// offer the clipboard.  the client asks for any data it doesn't
+	// have and we keep the offer until then.
+	m_transfer.cancel(id);
+	m_sentOffer[id].set(&clipboard, m_cache);
+	CString offer = m_sentOffer[id].marshall();
+	LOG((CLOG_DEBUG "send clipboard %d offer to \"%s\"", id, getName().c_str()));
+	CProtocolUtil::writef(getStream(), kMsgDClipboardOffer, id, 0, &offer);
+}
+
+bool
+CClientProxy1_4::recvClipboardOffer()
+{
+	// parse message
+	ClipboardID id;
+	UInt32 seqNum;
+	CString data;
+	if (!CProtocolUtil::readf(getStream(),
+							kMsgDClipboardOffer + 4, &id, &seqNum, &data)) {
+		return false;
+	}
+	LOG((CLOG_DEBUG "received client \"%s\" clipboard %d offer seqnum=%d", getName().c_str(), id, seqNum));
+
+	// validate
+	if (id >= kClipboardEnd) {
+		return false;
+	}
+	CClipboardOffer& offer = m_recvOffer[id];
+	if (!offer.unmarshall(data)) {
+		return false;
+	}
+	m_recvSeqNum[id] = seqNum;
+
+	// the client's clipboard changed so anything we're still sending
+	// it is out of date
+	m_transfer.cancel(id);
+
+	// use what's in the cache.  the rest is deferred until it's needed.
+	CClipboardOffer::CFormatList missing;
+	if (offer.resolve(m_cache, &missing)) {
+		LOG((CLOG_DEBUG "client \"%s\" clipboard %d is cached", getName().c_str(), id));
+	}
+	else {
+		LOG((CLOG_DEBUG "deferring %d client \"%s\" clipboard %d formats", missing.size(), getName().c_str(), id));
+	}
+	m_recvQueried[id] = false;
+
+	CClipboard clipboard;
+	offer.get(&clipboard, 0);
+	if (offer.isComplete()) {
+		offer.clear();
+	}
+	updateClipboard(id, seqNum, &clipboard);
+
+	return true;
+}
+
+bool
+CClientProxy1_4::recvClipboardFormats()
+{
+	// parse message.  nothing to do until the last chunk arrives.
+	ClipboardID id;
+	CString data;
+	bool done, failed;
+	if (!m_transfer.recv(&id, &data, &done, &failed)) {
+		return false;
+	}
+	if (!done) {
+		return true;
+	}
+	LOG((CLOG_DEBUG "received client \"%s\" clipboard %d formats size=%d%s", getName().c_str(), id, data.size(), failed ? " (failed)" : ""));
+
+	// ignore if we didn't ask for formats for the current offer.  a
+	// newer offer resets the query so formats for an older one are
+	// dropped here.  after a partial fill we may ask again.
+	CClipboardOffer& offer = m_recvOffer[id];
+	if (!offer.isValid() || !m_recvQueried[id]) {
+		LOG((CLOG_DEBUG "ignoring client \"%s\" clipboard %d formats for old offer", getName().c_str(), id));
+		return true;
+	}
+	m_recvQueried[id] = false;
+
+	// formats the client didn't send can't be had.  drop them so
+	// pastes waiting on them fail now instead of timing out.
+	if (failed || !offer.fill(data, m_cache)) {
+		LOG((CLOG_DEBUG "client \"%s\" can't supply some clipboard %d formats", getName().c_str(), id));
+		offer.dropMissing();
+	}
+
+	// offer is complete
+	CClipboard clipboard;
+	offer.get(&clipboard, 0);
+	offer.clear();
+	updateClipboard(id, m_recvSeqNum[id], &clipboard);
+
+	return true;
+}
+
+bool
+CClientProxy1_4::recvClipboardQuery()
+{
+	// parse message
+	ClipboardID id;
+	CClipboardOffer::CFormatList formats;
+	if (!CProtocolUtil::readf(getStream(),
+							kMsgQClipboard + 4, &id, &formats)) {
+		return false;
+	}
+	LOG((CLOG_DEBUG "received client \"%s\" query for %d clipboard %d formats", getName().c_str(), formats.size(), id));
+
+	// validate
+	if (id >= kClipboardEnd) {
+		return false;
+	}
+
+	// fail the request if we no longer have an offer with the data
+	const CClipboardOffer& offer = m_sentOffer[id];
+	if (!offer.isValid() || offer.getMissing(formats) != 0) {
+		LOG((CLOG_DEBUG "can't send clipboard %d formats to \"%s\"", id, getName().c_str()));
+		m_transfer.fail(id);
+		return true;
+	}
+
+	// send the requested data from the most recent offer
+	CString data = offer.marshallFormats(formats);
+	LOG((CLOG_DEBUG "send clipboard %d formats to \"%s\" size=%d", id, getName().c_str(), data.size()));
+	CSharedString sharedData;
+	sharedData.adopt(data);
+	m_transfer.send(id, sharedData);
+
+	return true;
+}
@@ -0,0 +1,56 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef CCLIENTPROXY1_4_H
+#define CCLIENTPROXY1_4_H
+
+#include "CClientProxy1_3.h"
+#include "CClipboardCache.h"
+#include "CClipboardOffer.h"
+#include "CClipboardTransfer.h"
+
+//! Proxy for client implementing protocol version 1.4
+class CClientProxy1_4 : public CClientProxy1_3 {
+public:
+	CClientProxy1_4(const CString& name, IStream* adoptedStream);
+	~CClientProxy1_4();
+
+	// CBaseClientProxy overrides
+	virtual void		requestClipboard(ClipboardID);
+
+	// IClient overrides
+	virtual void		grabClipboard(ClipboardID);
+
+protected:
+	// CClientProxy overrides
+	virtual bool		parseMessage(const UInt8* code);
+
+	// CClientProxy1_0 overrides
+	virtual void		sendClipboard(ClipboardID, const CClipboard&);
+
+private:
+	bool				recvClipboardOffer();
+	bool				recvClipboardFormats();
+	bool				recvClipboardQuery();
+
+private:
+	CClipboardCache		m_cache;
+	CClipboardTransfer	m_transfer;
+	CClipboardOffer		m_sentOffer[kClipboardEnd];
+	CClipboardOffer		m_recvOffer[kClipboardEnd];
+	UInt32				m_recvSeqNum[kClipboardEnd];
+	bool				m_recvQueried[kClipboardEnd];
+};
+
+#endif
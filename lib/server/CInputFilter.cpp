@@ -18,6 +18,7 @@
 #include "CKeyMap.h"
 #include "CEventQueue.h"
 #include "CLog.h"
+#include "CArch.h"
 #include "TMethodEventJob.h"
 #include <stdlib.h>
 #include <string.h>
@@ -535,6 +536,7 @@ CInputFilter::CKeystrokeAction::perform(const CEvent& event)
 {
 	CEvent::Type type = m_press ? IPlatformScreen::getKeyDownEvent() :
 								IPlatformScreen::getKeyUpEvent();
+	m_keyInfo->m_time = ARCH->time();
 	EVENTQUEUE->addEvent(CEvent(IPlatformScreen::getFakeInputBeginEvent(),
 								event.getTarget(), NULL,
 								CEvent::kDeliverImmediately));
@@ -30,6 +30,19 @@
 #include "CArch.h"
 #include <string.h>
 
+// report the time from capturing an input event to handling it
+static
+void
+logLatency(const char* type, double captureTime)
+{
+	// LOG evaluates its arguments before filtering so check first to
+	// keep the clock off the input path
+	if (CLOG->getFilter() >= CLog::kDEBUG2) {
+		LOG((CLOG_DEBUG2 "%s latency %.3fms", type, 1000.0 * (ARCH->time() - captureTime)));
+	}
+}
+
+
 //
 // CServer
 //
@@ -80,7 +93,7 @@ CServer::CServer(const CConfig& config, CPrimaryClient* primaryClient) :
 			clipboard.m_clipboard.empty();
 			clipboard.m_clipboard.close();
 		}
-		clipboard.m_clipboardData   = clipboard.m_clipboard.marshall();
+		clipboard.m_clipboardHash   = clipboard.m_clipboard.getHash();
 	}
 
 	// install event handlers
@@ -505,7 +518,7 @@ CServer::switchScreen(CBaseClientProxy* dst,
 
 		// send the clipboard data to new active screen
 		for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
-			m_active->setClipboard(id, &m_clipboards[id].m_clipboard);
+			sendClipboard(id);
 		}
 	}
 	else {
@@ -528,6 +541,31 @@ CServer::jumpToScreen(CBaseClientProxy* newScreen)
 	switchScreen(newScreen, x, y, false);
 }
 
+void
+CServer::sendClipboard(ClipboardID id)
+{
+	// only the primary screen can wait for deferred data.  other
+	// screens get the clipboard once the owner has sent all of it.
+	CClipboardInfo& clipboard = m_clipboards[id];
+	if (m_active != m_primaryClient &&
+		IClipboard::hasDeferred(&clipboard.m_clipboard)) {
+		requestClipboard(id);
+		return;
+	}
+	m_active->setClipboard(id, &clipboard.m_clipboard);
+}
+
+void
+CServer::requestClipboard(ClipboardID id)
+{
+	CClipboardInfo& clipboard = m_clipboards[id];
+	CClientList::const_iterator index =
+		m_clients.find(clipboard.m_clipboardOwner);
+	if (index != m_clients.end() && index->second != m_active) {
+		index->second->requestClipboard(id);
+	}
+}
+
 float
 CServer::mapToFraction(CBaseClientProxy* client,
 				EDirection dir, SInt32 x, SInt32 y) const
@@ -1204,7 +1242,7 @@ CServer::handleClipboardGrabbed(const CEvent& event, void* vclient)
 		clipboard.m_clipboard.empty();
 		clipboard.m_clipboard.close();
 	}
-	clipboard.m_clipboardData = clipboard.m_clipboard.marshall();
+	clipboard.m_clipboardHash = clipboard.m_clipboard.getHash();
 
 	// tell all other screens to take ownership of clipboard.  tell the
 	// grabber that it's clipboard isn't dirty.
@@ -1233,12 +1271,27 @@ CServer::handleClipboardChanged(const CEvent& event, void* vclient)
 	onClipboardChanged(sender, info->m_id, info->m_sequenceNumber);
 }
 
+void
+CServer::handleClipboardRequested(const CEvent& event, void* vclient)
+{
+	// ignore events from unknown clients
+	CBaseClientProxy* requester = reinterpret_cast<CBaseClientProxy*>(vclient);
+	if (m_clientSet.count(requester) == 0) {
+		return;
+	}
+	const IScreen::CClipboardInfo* info =
+		reinterpret_cast<const IScreen::CClipboardInfo*>(event.getData());
+	LOG((CLOG_DEBUG "screen \"%s\" requested clipboard %d data", getName(requester).c_str(), info->m_id));
+	requestClipboard(info->m_id);
+}
+
 void
 CServer::handleKeyDownEvent(const CEvent& event, void*)
 {
 	IPlatformScreen::CKeyInfo* info =
 		reinterpret_cast<IPlatformScreen::CKeyInfo*>(event.getData());
 	onKeyDown(info->m_key, info->m_mask, info->m_button, info->m_screens);
+	logLatency("key down", info->m_time);
 }
 
 void
@@ -1247,6 +1300,7 @@ CServer::handleKeyUpEvent(const CEvent& event, void*)
 	IPlatformScreen::CKeyInfo* info =
 		 reinterpret_cast<IPlatformScreen::CKeyInfo*>(event.getData());
 	onKeyUp(info->m_key, info->m_mask, info->m_button, info->m_screens);
+	logLatency("key up", info->m_time);
 }
 
 void
@@ -1255,6 +1309,7 @@ CServer::handleKeyRepeatEvent(const CEvent& event, void*)
 	IPlatformScreen::CKeyInfo* info =
 		reinterpret_cast<IPlatformScreen::CKeyInfo*>(event.getData());
 	onKeyRepeat(info->m_key, info->m_mask, info->m_count, info->m_button);
+	logLatency("key repeat", info->m_time);
 }
 
 void
@@ -1279,6 +1334,7 @@ CServer::handleMotionPrimaryEvent(const CEvent& event, void*)
 	IPlatformScreen::CMotionInfo* info =
 		reinterpret_cast<IPlatformScreen::CMotionInfo*>(event.getData());
 	onMouseMovePrimary(info->m_x, info->m_y);
+	logLatency("motion", info->m_time);
 }
 
 void
@@ -1287,6 +1343,7 @@ CServer::handleMotionSecondaryEvent(const CEvent& event, void*)
 	IPlatformScreen::CMotionInfo* info =
 		reinterpret_cast<IPlatformScreen::CMotionInfo*>(event.getData());
 	onMouseMoveSecondary(info->m_x, info->m_y);
+	logLatency("relative motion", info->m_time);
 }
 
 void
@@ -1472,16 +1529,18 @@ CServer::onClipboardChanged(CBaseClientProxy* sender,
 	// get data
 	sender->getClipboard(id, &clipboard.m_clipboard);
 
-	// ignore if data hasn't changed
-	CString data = clipboard.m_clipboard.marshall();
-	if (data == clipboard.m_clipboardData) {
+	// ignore if data hasn't changed.  we can't tell if deferred data
+	// has changed so assume it has.
+	CSharedString::Hash hash = clipboard.m_clipboard.getHash();
+	if (hash == clipboard.m_clipboardHash &&
+		!IClipboard::hasDeferred(&clipboard.m_clipboard)) {
 		LOG((CLOG_DEBUG "ignored screen \"%s\" update of clipboard %d (unchanged)", clipboard.m_clipboardOwner.c_str(), id));
 		return;
 	}
 
 	// got new data
 	LOG((CLOG_INFO "screen \"%s\" updated clipboard %d", clipboard.m_clipboardOwner.c_str(), id));
-	clipboard.m_clipboardData = data;
+	clipboard.m_clipboardHash = hash;
 
 	// tell all clients except the sender that the clipboard is dirty
 	for (CClientList::const_iterator index = m_clients.begin();
@@ -1491,7 +1550,7 @@ CServer::onClipboardChanged(CBaseClientProxy* sender,
 	}
 
 	// send the new clipboard to the active screen
-	m_active->setClipboard(id, &clipboard.m_clipboard);
+	sendClipboard(id);
 }
 
 void
@@ -1909,6 +1968,10 @@ CServer::addClient(CBaseClientProxy* client)
 							client->getEventTarget(),
 							new TMethodEventJob<CServer>(this,
 								&CServer::handleClipboardChanged, client));
+	EVENTQUEUE->adoptHandler(IScreen::getClipboardRequestedEvent(),
+							client->getEventTarget(),
+							new TMethodEventJob<CServer>(this,
+								&CServer::handleClipboardRequested, client));
 
 	// add to list
 	m_clientSet.insert(client);
@@ -1941,6 +2004,8 @@ CServer::removeClient(CBaseClientProxy* client)
 							client->getEventTarget());
 	EVENTQUEUE->removeHandler(CClientProxy::getClipboardChangedEvent(),
 							client->getEventTarget());
+	EVENTQUEUE->removeHandler(IScreen::getClipboardRequestedEvent(),
+							client->getEventTarget());
 
 	// remove from list
 	m_clients.erase(getName(client));
@@ -2084,7 +2149,7 @@ CServer::forceLeaveClient(CBaseClientProxy* client)
 
 CServer::CClipboardInfo::CClipboardInfo() :
 	m_clipboard(),
-	m_clipboardData(),
+	m_clipboardHash(0),
 	m_clipboardOwner(),
 	m_clipboardSeqNum(0)
 {
@@ -224,6 +224,14 @@ private:
 	// jump to screen
 	void				jumpToScreen(CBaseClientProxy*);
 
+	// send a clipboard to the active screen.  if the clipboard has
+	// deferred data that the active screen can't wait for then ask
+	// the clipboard's owner for it instead.
+	void				sendClipboard(ClipboardID);
+
+	// ask the clipboard's owner for its deferred data
+	void				requestClipboard(ClipboardID);
+
 	// convert pixel position to fraction, using x or y depending on the
 	// direction.
 	float				mapToFraction(CBaseClientProxy*, EDirection,
@@ -311,6 +319,7 @@ private:
 	void				handleShapeChanged(const CEvent&, void*);
 	void				handleClipboardGrabbed(const CEvent&, void*);
 	void				handleClipboardChanged(const CEvent&, void*);
+	void				handleClipboardRequested(const CEvent&, void*);
 	void				handleKeyDownEvent(const CEvent&, void*);
 	void				handleKeyUpEvent(const CEvent&, void*);
 	void				handleKeyRepeatEvent(const CEvent&, void*);
@@ -376,7 +385,7 @@ private:
 
 	public:
 		CClipboard		m_clipboard;
-		CString			m_clipboardData;
+		CSharedString::Hash	m_clipboardHash;
 		CString			m_clipboardOwner;
 		UInt32			m_clipboardSeqNum;
 	};
@@ -39,8 +39,9 @@ CClipboard::empty()
 
 	// clear all data
 	for (SInt32 index = 0; index < kNumFormats; ++index) {
-		m_data[index]  = "";
-		m_added[index] = false;
+		m_data[index]     = CSharedString();
+		m_added[index]    = false;
+		m_deferred[index] = false;
 	}
 
 	// save time
@@ -58,8 +59,31 @@ CClipboard::add(EFormat format, const CString& data)
 	assert(m_open);
 	assert(m_owner);
 
-	m_data[format]  = data;
-	m_added[format] = true;
+	m_data[format]     = CSharedString(data);
+	m_added[format]    = true;
+	m_deferred[format] = false;
+}
+
+void
+CClipboard::addShared(EFormat format, const CSharedString& data)
+{
+	assert(m_open);
+	assert(m_owner);
+
+	m_data[format]     = data;
+	m_added[format]    = true;
+	m_deferred[format] = false;
+}
+
+void
+CClipboard::addDeferred(EFormat format)
+{
+	assert(m_open);
+	assert(m_owner);
+
+	m_data[format]     = CSharedString();
+	m_added[format]    = true;
+	m_deferred[format] = true;
 }
 
 bool
@@ -96,11 +120,25 @@ CClipboard::has(EFormat format) const
 
 CString
 CClipboard::get(EFormat format) const
+{
+	assert(m_open);
+	return m_data[format].str();
+}
+
+CSharedString
+CClipboard::getShared(EFormat format) const
 {
 	assert(m_open);
 	return m_data[format];
 }
 
+bool
+CClipboard::isDeferred(EFormat format) const
+{
+	assert(m_open);
+	return m_deferred[format];
+}
+
 void
 CClipboard::unmarshall(const CString& data, Time time)
 {
@@ -112,3 +150,9 @@ CClipboard::marshall() const
 {
 	return IClipboard::marshall(this);
 }
+
+CSharedString::Hash
+CClipboard::getHash() const
+{
+	return IClipboard::hash(this);
+}
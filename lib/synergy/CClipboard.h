@@ -19,7 +19,9 @@
 
 //! Memory buffer clipboard
 /*!
-This class implements a clipboard that stores data in memory.
+This class implements a clipboard that stores data in memory.  The
+data for each format is held in a CSharedString so copying between
+CClipboard objects shares rather than duplicates the data.
 */
 class CClipboard : public IClipboard {
 public:
@@ -47,6 +49,13 @@ public:
 	*/
 	CString				marshall() const;
 
+	//! Get content hash
+	/*!
+	Return a hash of this clipboard's data.  Clipboards with the same
+	formats and data have the same hash.
+	*/
+	CSharedString::Hash	getHash() const;
+
 	//@}
 
 	// IClipboard overrides
@@ -57,6 +66,10 @@ public:
 	virtual Time		getTime() const;
 	virtual bool		has(EFormat) const;
 	virtual CString		get(EFormat) const;
+	virtual void		addShared(EFormat, const CSharedString& data);
+	virtual CSharedString	getShared(EFormat) const;
+	virtual void		addDeferred(EFormat);
+	virtual bool		isDeferred(EFormat) const;
 
 private:
 	mutable bool		m_open;
@@ -64,7 +77,8 @@ private:
 	bool				m_owner;
 	Time				m_timeOwned;
 	bool				m_added[kNumFormats];
-	CString				m_data[kNumFormats];
+	bool				m_deferred[kNumFormats];
+	CSharedString		m_data[kNumFormats];
 };
 
 #endif
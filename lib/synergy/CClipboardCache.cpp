@@ -0,0 +1,107 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "CClipboardCache.h"
+
+//
+// CClipboardCache
+//
+
+CClipboardCache::CClipboardCache(UInt32 maxEntries, UInt32 maxBytes) :
+	m_maxEntries(maxEntries),
+	m_maxBytes(maxBytes),
+	m_numBytes(0)
+{
+	// do nothing
+}
+
+CClipboardCache::~CClipboardCache()
+{
+	// do nothing
+}
+
+void
+CClipboardCache::insert(const CSharedString& data)
+{
+	// don't bother with empty data or data that won't fit
+	if (data.empty() || data.size() > m_maxBytes || m_maxEntries == 0) {
+		return;
+	}
+
+	// if we already have it then just make it the most recently used
+	CSharedString dummy;
+	if (find(data.getHash(), data.size(), &dummy)) {
+		return;
+	}
+
+	// make room
+	while (m_entries.size() >= m_maxEntries ||
+			m_numBytes + data.size() > m_maxBytes) {
+		erase();
+	}
+
+	// add
+	m_entries.push_front(data);
+	m_index[CKey(data.getHash(), data.size())] = m_entries.begin();
+	m_numBytes += data.size();
+}
+
+bool
+CClipboardCache::find(CSharedString::Hash hash, UInt32 size,
+				CSharedString* data)
+{
+	assert(data != NULL);
+
+	CIndex::iterator i = m_index.find(CKey(hash, size));
+	if (i == m_index.end()) {
+		return false;
+	}
+
+	// move to front
+	m_entries.splice(m_entries.begin(), m_entries, i->second);
+	*data = m_entries.front();
+	return true;
+}
+
+void
+CClipboardCache::clear()
+{
+	m_index.clear();
+	m_entries.clear();
+	m_numBytes = 0;
+}
+
+UInt32
+CClipboardCache::getNumEntries() const
+{
+	return m_entries.size();
+}
+
+UInt32
+CClipboardCache::getNumBytes() const
+{
+	return m_numBytes;
+}
+
+void
+CClipboardCache::erase()
+{
+	assert(!m_entries.empty());
+
+	// discard least recently used entry
+	const CSharedString& data = m_entries.back();
+	m_numBytes -= data.size();
+	m_index.erase(CKey(data.getHash(), data.size()));
+	m_entries.pop_back();
+}
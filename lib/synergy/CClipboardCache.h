@@ -0,0 +1,93 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef CCLIPBOARDCACHE_H
+#define CCLIPBOARDCACHE_H
+
+#include "CSharedString.h"
+#include "stdlist.h"
+#include "stdmap.h"
+
+//! Content addressed clipboard data cache
+/*!
+This class remembers recently transferred clipboard data keyed by the
+hash of the data.  When the cache is full the least recently used data
+is discarded.  The cache is bounded both in the number of entries and
+in the total size of the data.  Since the data is held in a
+CSharedString, data that's also held by a clipboard doesn't take any
+additional memory.
+*/
+class CClipboardCache {
+public:
+	/*!
+	Creates a cache that holds at most \p maxEntries items totaling at
+	most \p maxBytes bytes.
+	*/
+	CClipboardCache(UInt32 maxEntries, UInt32 maxBytes);
+	~CClipboardCache();
+
+	//! @name manipulators
+	//@{
+
+	//! Add data
+	/*!
+	Adds \p data to the cache as the most recently used entry,
+	discarding the least recently used entries as necessary.  Data
+	larger than the cache is not added.
+	*/
+	void				insert(const CSharedString& data);
+
+	//! Find data
+	/*!
+	Looks for data with hash \p hash and size \p size.  If found, the
+	data becomes the most recently used entry, is returned in \p data
+	and this returns true.  Otherwise it returns false.
+	*/
+	bool				find(CSharedString::Hash hash, UInt32 size,
+							CSharedString* data);
+
+	//! Discard all data
+	void				clear();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get number of entries
+	UInt32				getNumEntries() const;
+
+	//! Get total size of data
+	UInt32				getNumBytes() const;
+
+	//@}
+
+private:
+	void				erase();
+
+private:
+	// entries are indexed by hash and size since lookups match both
+	typedef std::list<CSharedString> CEntryList;
+	typedef std::pair<CSharedString::Hash, UInt32> CKey;
+	typedef std::map<CKey, CEntryList::iterator> CIndex;
+
+	UInt32				m_maxEntries;
+	UInt32				m_maxBytes;
+	UInt32				m_numBytes;
+
+	// entries in most recently used order
+	CEntryList			m_entries;
+	CIndex				m_index;
+};
+
+#endif
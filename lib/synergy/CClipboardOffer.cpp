@@ -0,0 +1,335 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "CClipboardOffer.h"
+#include "CClipboard.h"
+#include "CClipboardCache.h"
+#include "ProtocolTypes.h"
+
+//
+// CClipboardOffer
+//
+
+CClipboardOffer::CClipboardOffer() :
+	m_valid(false)
+{
+	// do nothing
+}
+
+CClipboardOffer::~CClipboardOffer()
+{
+	// do nothing
+}
+
+void
+CClipboardOffer::set(const IClipboard* clipboard, CClipboardCache& cache)
+{
+	assert(clipboard != NULL);
+
+	clear();
+
+	// FIXME -- use current time
+	clipboard->open(0);
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		IClipboard::EFormat eFormat = static_cast<IClipboard::EFormat>(format);
+		if (!clipboard->has(eFormat)) {
+			continue;
+		}
+		CFormat& info  = m_formats[format];
+		info.m_offered = true;
+		if (clipboard->isDeferred(eFormat)) {
+			// offered without data until fill() supplies it
+			info.m_resolved = false;
+			info.m_size     = kClipboardUnknownSize;
+			info.m_hash     = 0;
+		}
+		else {
+			info.m_resolved = true;
+			info.m_data     = clipboard->getShared(eFormat);
+			info.m_size     = info.m_data.size();
+			info.m_hash     = info.m_data.getHash();
+			cache.insert(info.m_data);
+		}
+	}
+	clipboard->close();
+
+	m_valid = true;
+}
+
+bool
+CClipboardOffer::unmarshall(const CString& data)
+{
+	clear();
+
+	// read the number of formats
+	if (data.size() < 4) {
+		return false;
+	}
+	const char* index = data.data();
+	const UInt32 numFormats = readUInt32(index);
+	index += 4;
+	if (data.size() != 4 + 16 * numFormats) {
+		return false;
+	}
+
+	// read each format
+	for (UInt32 i = 0; i < numFormats; ++i) {
+		const UInt32 format = readUInt32(index);
+		const UInt32 size   = readUInt32(index + 4);
+		CSharedString::Hash hash =
+			(static_cast<CSharedString::Hash>(readUInt32(index +  8)) << 32) |
+			 static_cast<CSharedString::Hash>(readUInt32(index + 12));
+		index += 16;
+
+		// ignore formats we don't know about.  see IClipboard::unmarshall.
+		if (format < static_cast<UInt32>(IClipboard::kNumFormats)) {
+			CFormat& info   = m_formats[format];
+			info.m_offered  = true;
+			info.m_resolved = false;
+			info.m_size     = size;
+			info.m_hash     = hash;
+		}
+	}
+
+	m_valid = true;
+	return true;
+}
+
+bool
+CClipboardOffer::resolve(CClipboardCache& cache, CFormatList* missing)
+{
+	assert(missing != NULL);
+
+	missing->clear();
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		CFormat& info = m_formats[format];
+		if (!info.m_offered || info.m_resolved) {
+			continue;
+		}
+
+		// empty data is never sent or cached
+		if (info.m_size == 0) {
+			info.m_data     = CSharedString();
+			info.m_resolved = true;
+		}
+		else if (info.m_size != kClipboardUnknownSize &&
+				cache.find(info.m_hash, info.m_size, &info.m_data)) {
+			info.m_resolved = true;
+		}
+		else {
+			missing->push_back(static_cast<UInt8>(format));
+		}
+	}
+	return missing->empty();
+}
+
+bool
+CClipboardOffer::fill(const CString& data, CClipboardCache& cache)
+{
+	CClipboard clipboard;
+	clipboard.unmarshall(data, 0);
+	return fill(&clipboard, cache);
+}
+
+bool
+CClipboardOffer::fill(const IClipboard* clipboard, CClipboardCache& cache)
+{
+	assert(clipboard != NULL);
+
+	clipboard->open(0);
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		IClipboard::EFormat eFormat = static_cast<IClipboard::EFormat>(format);
+		CFormat& info = m_formats[format];
+		if (!info.m_offered || info.m_resolved ||
+			!clipboard->has(eFormat) || clipboard->isDeferred(eFormat)) {
+			continue;
+		}
+
+		// accept the data only if it's what we were offered.  we can't
+		// check data whose size wasn't known.
+		CSharedString formatData = clipboard->getShared(eFormat);
+		if (info.m_size == kClipboardUnknownSize ||
+			(formatData.size() == info.m_size &&
+			formatData.getHash() == info.m_hash)) {
+			info.m_size     = formatData.size();
+			info.m_hash     = formatData.getHash();
+			info.m_data     = formatData;
+			info.m_resolved = true;
+			cache.insert(formatData);
+		}
+	}
+	clipboard->close();
+
+	return isComplete();
+}
+
+void
+CClipboardOffer::dropMissing()
+{
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		CFormat& info = m_formats[format];
+		if (info.m_offered && !info.m_resolved) {
+			info = CFormat();
+		}
+	}
+}
+
+void
+CClipboardOffer::clear()
+{
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		m_formats[format] = CFormat();
+	}
+	m_valid = false;
+}
+
+CString
+CClipboardOffer::marshall() const
+{
+	UInt32 numFormats = 0;
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		if (m_formats[format].m_offered) {
+			++numFormats;
+		}
+	}
+
+	CString data;
+	data.reserve(4 + 16 * numFormats);
+	writeUInt32(&data, numFormats);
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		const CFormat& info = m_formats[format];
+		if (info.m_offered) {
+			writeUInt32(&data, format);
+			writeUInt32(&data, info.m_size);
+			writeUInt32(&data, static_cast<UInt32>(info.m_hash >> 32));
+			writeUInt32(&data, static_cast<UInt32>(info.m_hash & 0xffffffffu));
+		}
+	}
+	return data;
+}
+
+CString
+CClipboardOffer::marshallFormats(const CFormatList& formats) const
+{
+	CClipboard clipboard;
+	clipboard.open(0);
+	clipboard.empty();
+	for (CFormatList::const_iterator index = formats.begin();
+								index != formats.end(); ++index) {
+		if (*index < IClipboard::kNumFormats) {
+			const CFormat& info = m_formats[*index];
+			if (info.m_offered && info.m_resolved) {
+				clipboard.addShared(static_cast<IClipboard::EFormat>(*index),
+							info.m_data);
+			}
+		}
+	}
+	clipboard.close();
+	return clipboard.marshall();
+}
+
+bool
+CClipboardOffer::isValid() const
+{
+	return m_valid;
+}
+
+bool
+CClipboardOffer::isComplete() const
+{
+	if (!m_valid) {
+		return false;
+	}
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		const CFormat& info = m_formats[format];
+		if (info.m_offered && !info.m_resolved) {
+			return false;
+		}
+	}
+	return true;
+}
+
+UInt32
+CClipboardOffer::getMissing(const CFormatList& formats) const
+{
+	UInt32 mask = 0;
+	for (CFormatList::const_iterator index = formats.begin();
+								index != formats.end(); ++index) {
+		if (*index < IClipboard::kNumFormats) {
+			const CFormat& info = m_formats[*index];
+			if (info.m_offered && !info.m_resolved) {
+				mask |= (1u << *index);
+			}
+		}
+	}
+	return mask;
+}
+
+void
+CClipboardOffer::get(IClipboard* clipboard, IClipboard::Time time) const
+{
+	assert(clipboard != NULL);
+	assert(isValid());
+
+	clipboard->open(time);
+	clipboard->empty();
+	for (SInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		const CFormat& info = m_formats[format];
+		IClipboard::EFormat eFormat = static_cast<IClipboard::EFormat>(format);
+		if (!info.m_offered) {
+			continue;
+		}
+		if (info.m_resolved) {
+			clipboard->addShared(eFormat, info.m_data);
+		}
+		else {
+			clipboard->addDeferred(eFormat);
+		}
+	}
+	clipboard->close();
+}
+
+UInt32
+CClipboardOffer::readUInt32(const char* buf)
+{
+	const unsigned char* ubuf = reinterpret_cast<const unsigned char*>(buf);
+	return	(static_cast<UInt32>(ubuf[0]) << 24) |
+			(static_cast<UInt32>(ubuf[1]) << 16) |
+			(static_cast<UInt32>(ubuf[2]) <<  8) |
+			 static_cast<UInt32>(ubuf[3]);
+}
+
+void
+CClipboardOffer::writeUInt32(CString* buf, UInt32 v)
+{
+	*buf += static_cast<UInt8>((v >> 24) & 0xff);
+	*buf += static_cast<UInt8>((v >> 16) & 0xff);
+	*buf += static_cast<UInt8>((v >>  8) & 0xff);
+	*buf += static_cast<UInt8>( v        & 0xff);
+}
+
+
+//
+// CClipboardOffer::CFormat
+//
+
+CClipboardOffer::CFormat::CFormat() :
+	m_offered(false),
+	m_resolved(false),
+	m_size(0),
+	m_hash(0),
+	m_data()
+{
+	// do nothing
+}
@@ -0,0 +1,168 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef CCLIPBOARDOFFER_H
+#define CCLIPBOARDOFFER_H
+
+#include "IClipboard.h"
+#include "stdvector.h"
+
+class CClipboardCache;
+
+//! Clipboard offer
+/*!
+An offer describes the contents of a clipboard by the size and hash of
+the data in each format without the data itself.  The sender of a
+clipboard creates an offer with set() and sends marshall()'s result.
+The receiver unmarshall()'s it and calls resolve() to take what it can
+from its cache.  get() yields the clipboard with the missing formats
+deferred.  When the missing data is needed the receiver requests it
+and passes the reply to fill().  See kMsgDClipboardOffer.
+*/
+class CClipboardOffer {
+public:
+	//! List of clipboard formats
+	typedef std::vector<UInt8> CFormatList;
+
+	CClipboardOffer();
+	~CClipboardOffer();
+
+	//! @name manipulators
+	//@{
+
+	//! Make an offer
+	/*!
+	Set the offer to describe \p clipboard.  The offer keeps a
+	reference to the clipboard's data so it can later supply formats
+	requested by the receiver.  The data is also added to \p cache,
+	since the receiver will have it once the transfer completes.
+	Deferred formats are offered with size kClipboardUnknownSize and
+	their data must be supplied to fill() before marshallFormats()
+	can include them.
+	*/
+	void				set(const IClipboard* clipboard,
+							CClipboardCache& cache);
+
+	//! Unmarshall an offer
+	/*!
+	Set the offer from a marshalled offer.  The offer doesn't have
+	any data until resolve() and fill() supply it.  Returns false if
+	\p data is not a valid offer.
+	*/
+	bool				unmarshall(const CString& data);
+
+	//! Take data from cache
+	/*!
+	Take data for the formats in the offer from \p cache.  Formats not
+	in the cache are returned in \p missing.  Returns true iff the
+	offer is complete.
+	*/
+	bool				resolve(CClipboardCache& cache,
+							CFormatList* missing);
+
+	//! Take data from a reply
+	/*!
+	Take data for missing formats from \p data, a marshalled clipboard
+	sent in reply to a request for the missing formats.  Formats that
+	don't match the offer are ignored, except that any data is accepted
+	for formats of unknown size.  The accepted data is added to \p cache.
+	Returns true iff the offer is complete.
+	*/
+	bool				fill(const CString& data, CClipboardCache& cache);
+
+	//! Take data from a clipboard
+	/*!
+	Like fill() but takes the data from \p clipboard.  Deferred formats
+	in \p clipboard are ignored.
+	*/
+	bool				fill(const IClipboard* clipboard,
+							CClipboardCache& cache);
+
+	//! Give up on missing data
+	/*!
+	Stop offering the formats that have no data, leaving the offer
+	complete.  Used when the sender can't supply them.
+	*/
+	void				dropMissing();
+
+	//! Discard the offer
+	void				clear();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Marshall the offer
+	CString				marshall() const;
+
+	//! Marshall requested formats
+	/*!
+	Return a marshalled clipboard containing the offered data for the
+	formats in \p formats.  Formats not in the offer are skipped.
+	*/
+	CString				marshallFormats(const CFormatList& formats) const;
+
+	//! Check for an offer
+	/*!
+	Returns true iff the offer has been set or unmarshalled and not
+	cleared since.
+	*/
+	bool				isValid() const;
+
+	//! Check for data
+	/*!
+	Returns true iff the offer has data for every offered format.
+	*/
+	bool				isComplete() const;
+
+	//! Get formats without data
+	/*!
+	Returns a mask with bit (1 << format) set for each format in
+	\p formats that is offered but has no data.
+	*/
+	UInt32				getMissing(const CFormatList& formats) const;
+
+	//! Get the clipboard
+	/*!
+	Store the offered data in \p clipboard.  Formats without data are
+	added with IClipboard::addDeferred().  Sets the clipboard time to
+	\c time.  The offer must be valid.
+	*/
+	void				get(IClipboard* clipboard,
+							IClipboard::Time time) const;
+
+	//@}
+
+private:
+	class CFormat {
+	public:
+		CFormat();
+
+	public:
+		bool				m_offered;
+		bool				m_resolved;
+		UInt32				m_size;
+		CSharedString::Hash	m_hash;
+		CSharedString		m_data;
+	};
+
+	static UInt32		readUInt32(const char*);
+	static void			writeUInt32(CString*, UInt32);
+
+private:
+	bool				m_valid;
+	CFormat				m_formats[IClipboard::kNumFormats];
+};
+
+#endif
@@ -0,0 +1,252 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "CClipboardTransfer.h"
+#include "CProtocolUtil.h"
+#include "ProtocolTypes.h"
+#include "IStream.h"
+#include "CLog.h"
+#include "IEventQueue.h"
+#include "TMethodEventJob.h"
+
+//
+// CClipboardTransfer
+//
+
+CClipboardTransfer::CClipboardTransfer(IStream* stream) :
+	m_stream(stream),
+	m_target(stream->getEventTarget()),
+	m_waiting(false),
+	m_next(0)
+{
+	EVENTQUEUE->adoptHandler(IStream::getOutputFlushedEvent(), m_target,
+							new TMethodEventJob<CClipboardTransfer>(this,
+								&CClipboardTransfer::handleOutputFlushed));
+}
+
+CClipboardTransfer::~CClipboardTransfer()
+{
+	EVENTQUEUE->removeHandler(IStream::getOutputFlushedEvent(), m_target);
+}
+
+void
+CClipboardTransfer::send(ClipboardID id, const CSharedString& data)
+{
+	assert(id < kClipboardEnd);
+
+	cancel(id);
+
+	COutgoing& out = m_send[id];
+	out.m_sending  = true;
+	out.m_offset   = 0;
+	out.m_data     = data;
+
+	// send the first chunk now unless another is already on its way.
+	// in that case this clipboard gets its turn after the flush.
+	if (!m_waiting) {
+		sendChunk();
+	}
+}
+
+void
+CClipboardTransfer::cancel(ClipboardID id)
+{
+	assert(id < kClipboardEnd);
+
+	COutgoing& out = m_send[id];
+	if (out.m_sending && out.m_offset > 0) {
+		LOG((CLOG_DEBUG1 "cancel clipboard %d transfer at %d of %d bytes", id, out.m_offset, out.m_data.size()));
+		CString empty;
+		CProtocolUtil::writef(m_stream, kMsgDClipboardFormats,
+							id, kClipboardChunkCancel, 0, &empty);
+	}
+	out = COutgoing();
+}
+
+void
+CClipboardTransfer::fail(ClipboardID id)
+{
+	assert(id < kClipboardEnd);
+
+	// a cancel discards anything we've already sent of the clipboard
+	LOG((CLOG_DEBUG1 "fail clipboard %d transfer", id));
+	m_send[id] = COutgoing();
+	CString empty;
+	CProtocolUtil::writef(m_stream, kMsgDClipboardFormats,
+							id, kClipboardChunkCancel, 0, &empty);
+}
+
+bool
+CClipboardTransfer::recv(ClipboardID* id, CString* data,
+				bool* done, bool* failed)
+{
+	assert(id     != NULL);
+	assert(data   != NULL);
+	assert(done   != NULL);
+	assert(failed != NULL);
+
+	// parse
+	UInt8 mark;
+	UInt32 size;
+	CString chunk;
+	if (!CProtocolUtil::readf(m_stream, kMsgDClipboardFormats + 4,
+							id, &mark, &size, &chunk)) {
+		return false;
+	}
+
+	// validate
+	if (*id >= kClipboardEnd) {
+		return false;
+	}
+
+	*done   = false;
+	*failed = false;
+	CIncoming& in = m_recv[*id];
+	switch (mark) {
+	case kClipboardChunkStart:
+		in = CIncoming();
+		if (size > kClipboardTransferMaxSize) {
+			LOG((CLOG_WARN "clipboard %d data too large: %d bytes", *id, size));
+			return true;
+		}
+		LOG((CLOG_DEBUG1 "recv clipboard %d start size=%d", *id, size));
+		in.m_receiving = true;
+		in.m_size      = size;
+
+		// the size is only the peer's claim so don't reserve more than
+		// a few chunks up front.  the buffer grows as chunks arrive.
+		in.m_data.reserve(size < 4 * kClipboardChunkSize ?
+							size : 4 * kClipboardChunkSize);
+		break;
+
+	case kClipboardChunkData:
+		// ignore chunks from a transfer we've discarded
+		if (!in.m_receiving) {
+			return true;
+		}
+		break;
+
+	case kClipboardChunkCancel:
+		LOG((CLOG_DEBUG1 "recv clipboard %d cancel", *id));
+		in      = CIncoming();
+		*done   = true;
+		*failed = true;
+		return true;
+
+	default:
+		return false;
+	}
+
+	// append
+	if (chunk.size() > in.m_size - in.m_data.size()) {
+		LOG((CLOG_WARN "clipboard %d data overflow", *id));
+		in = CIncoming();
+		return false;
+	}
+	in.m_data += chunk;
+
+	// check for the end
+	if (in.m_data.size() == in.m_size) {
+		LOG((CLOG_DEBUG "recv clipboard %d complete size=%d", *id, in.m_size));
+		data->swap(in.m_data);
+		in    = CIncoming();
+		*done = true;
+	}
+	return true;
+}
+
+bool
+CClipboardTransfer::isSending(ClipboardID id) const
+{
+	assert(id < kClipboardEnd);
+
+	return m_send[id].m_sending;
+}
+
+void
+CClipboardTransfer::sendChunk()
+{
+	// find the next clipboard with data to send
+	ClipboardID id = m_next;
+	while (!m_send[id].m_sending) {
+		if (++id == kClipboardEnd) {
+			id = 0;
+		}
+		if (id == m_next) {
+			// nothing to send
+			m_waiting = false;
+			return;
+		}
+	}
+	m_next = static_cast<ClipboardID>((id + 1) % kClipboardEnd);
+
+	// send the next chunk
+	COutgoing& out = m_send[id];
+	UInt32 size    = out.m_data.size();
+	UInt32 n       = size - out.m_offset;
+	if (n > kClipboardChunkSize) {
+		n = kClipboardChunkSize;
+	}
+	CString chunk(out.m_data.data() + out.m_offset, n);
+	if (out.m_offset == 0) {
+		LOG((CLOG_DEBUG1 "send clipboard %d start size=%d", id, size));
+		CProtocolUtil::writef(m_stream, kMsgDClipboardFormats,
+							id, kClipboardChunkStart, size, &chunk);
+	}
+	else {
+		CProtocolUtil::writef(m_stream, kMsgDClipboardFormats,
+							id, kClipboardChunkData, 0, &chunk);
+	}
+	out.m_offset += n;
+
+	// done with this clipboard if that was the last chunk
+	if (out.m_offset == size) {
+		out = COutgoing();
+	}
+	m_waiting = true;
+}
+
+void
+CClipboardTransfer::handleOutputFlushed(const CEvent&, void*)
+{
+	if (m_waiting) {
+		sendChunk();
+	}
+}
+
+
+//
+// CClipboardTransfer::COutgoing
+//
+
+CClipboardTransfer::COutgoing::COutgoing() :
+	m_sending(false),
+	m_offset(0),
+	m_data()
+{
+	// do nothing
+}
+
+
+//
+// CClipboardTransfer::CIncoming
+//
+
+CClipboardTransfer::CIncoming::CIncoming() :
+	m_receiving(false),
+	m_size(0),
+	m_data()
+{
+	// do nothing
+}
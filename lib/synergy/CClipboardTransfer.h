@@ -0,0 +1,130 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef CCLIPBOARDTRANSFER_H
+#define CCLIPBOARDTRANSFER_H
+
+#include "ClipboardTypes.h"
+#include "CSharedString.h"
+#include "CEvent.h"
+
+class IStream;
+
+//! Chunked clipboard data transfer
+/*!
+This class sends and receives clipboard data as a sequence of
+kMsgDClipboardFormats chunks.  Only one chunk is written to the stream
+at a time;  the next is written when the stream's output has been
+flushed.  Messages written in the meantime, such as mouse motion, go
+out ahead of the rest of the clipboard instead of waiting behind it.
+
+While sending, the data is shared with the caller rather than copied.
+While receiving, each clipboard holds at most one partial reply of at
+most kClipboardTransferMaxSize bytes.
+*/
+class CClipboardTransfer {
+public:
+	/*!
+	Transfers clipboard data over \p stream, which must outlive this
+	object.
+	*/
+	CClipboardTransfer(IStream* stream);
+	~CClipboardTransfer();
+
+	//! @name manipulators
+	//@{
+
+	//! Send data
+	/*!
+	Start sending \p data for clipboard \p id, cancelling any data
+	still being sent for that clipboard.
+	*/
+	void				send(ClipboardID id, const CSharedString& data);
+
+	//! Cancel sending
+	/*!
+	Stop sending data for clipboard \p id.  If the receiver already has
+	part of the data then it's told to discard it.
+	*/
+	void				cancel(ClipboardID id);
+
+	//! Fail a request
+	/*!
+	Tell the receiver that no data is coming for its request for
+	clipboard \p id, cancelling any data still being sent for it.
+	*/
+	void				fail(ClipboardID id);
+
+	//! Receive a chunk
+	/*!
+	Read the rest of a kMsgDClipboardFormats message from the stream.
+	Returns false if the message is invalid.  Otherwise sets \p id to
+	the clipboard and \p done to true iff that clipboard's data is now
+	complete, in which case the data is returned in \p data.  If the
+	sender cancelled the reply instead then \p done and \p failed are
+	both true and there's no data.
+	*/
+	bool				recv(ClipboardID* id, CString* data,
+							bool* done, bool* failed);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Test if sending
+	/*!
+	Returns true iff data for clipboard \p id is still being sent.
+	*/
+	bool				isSending(ClipboardID id) const;
+
+	//@}
+
+private:
+	void				sendChunk();
+	void				handleOutputFlushed(const CEvent&, void*);
+
+private:
+	class COutgoing {
+	public:
+		COutgoing();
+
+	public:
+		bool			m_sending;
+		UInt32			m_offset;
+		CSharedString	m_data;
+	};
+	class CIncoming {
+	public:
+		CIncoming();
+
+	public:
+		bool			m_receiving;
+		UInt32			m_size;
+		CString			m_data;
+	};
+
+	IStream*			m_stream;
+	void*				m_target;
+
+	// true while a chunk is waiting to be flushed
+	bool				m_waiting;
+
+	// next clipboard to send a chunk for.  clipboards take turns.
+	ClipboardID			m_next;
+
+	COutgoing			m_send[kClipboardEnd];
+	CIncoming			m_recv[kClipboardEnd];
+};
+
+#endif
@@ -15,18 +15,110 @@
 #include "CKeyMap.h"
 #include "KeyTypes.h"
 #include "CLog.h"
+#include <algorithm>
 #include <assert.h>
 #include <ctype.h>
 #include <stdlib.h>
 
-CKeyMap::CNameToKeyMap*			CKeyMap::s_nameToKeyMap      = NULL;
-CKeyMap::CNameToModifierMap*	CKeyMap::s_nameToModifierMap = NULL;
-CKeyMap::CKeyToNameMap*			CKeyMap::s_keyToNameMap      = NULL;
-CKeyMap::CModifierToNameMap*	CKeyMap::s_modifierToNameMap = NULL;
+CKeyMap::CKeyNameIndex*			CKeyMap::s_keyNamesByName = NULL;
+CKeyMap::CKeyNameIndex*			CKeyMap::s_keyNamesByID   = NULL;
+
+// compare key names the same way as CStringUtil::CaselessCmp
+static
+int
+compareKeyNames(const char* a, const char* b)
+{
+	for (; *a != '\0' && tolower(*a) == tolower(*b); ++a, ++b) {
+		// do nothing
+	}
+	return tolower(*a) - tolower(*b);
+}
+
+static
+bool
+keyNameLess(const KeyNameMapEntry* a, const KeyNameMapEntry* b)
+{
+	return (compareKeyNames(a->m_name, b->m_name) < 0);
+}
+
+static
+bool
+keyIDLess(const KeyNameMapEntry* a, const KeyNameMapEntry* b)
+{
+	return (a->m_id < b->m_id);
+}
+
+// insert \p x into sorted list \p list if it's not already there
+template <class T>
+static
+void
+insertSorted(std::vector<T>& list, T x)
+{
+	typename std::vector<T>::iterator i =
+		std::lower_bound(list.begin(), list.end(), x);
+	if (i == list.end() || *i != x) {
+		list.insert(i, x);
+	}
+}
+
+// true iff key \p item is compatible with the given modifiers.  see
+// CKeyMap::findCompatibleKey().
+static
+bool
+isCompatibleKey(const CKeyMap::KeyItem& item,
+				KeyModifierMask required, KeyModifierMask sensitive)
+{
+	return ((item.m_sensitive & sensitive) == 0 ||
+			(item.m_required & sensitive) == (required & sensitive));
+}
+
+// most memoized mapKey() results to keep
+static const size_t		s_maxKeyPlans = 256;
+
+// orders active modifier entries for comparing memoized mapKey() args
+static
+bool
+activeModifierLess(const CKeyMap::ModifierToKeys::value_type& a,
+				const CKeyMap::ModifierToKeys::value_type& b)
+{
+	if (a.first != b.first) {
+		return (a.first < b.first);
+	}
+	const CKeyMap::KeyItem& x = a.second;
+	const CKeyMap::KeyItem& y = b.second;
+	if (x.m_id != y.m_id) {
+		return (x.m_id < y.m_id);
+	}
+	if (x.m_group != y.m_group) {
+		return (x.m_group < y.m_group);
+	}
+	if (x.m_button != y.m_button) {
+		return (x.m_button < y.m_button);
+	}
+	if (x.m_required != y.m_required) {
+		return (x.m_required < y.m_required);
+	}
+	if (x.m_sensitive != y.m_sensitive) {
+		return (x.m_sensitive < y.m_sensitive);
+	}
+	if (x.m_generates != y.m_generates) {
+		return (x.m_generates < y.m_generates);
+	}
+	if (x.m_dead != y.m_dead) {
+		return (x.m_dead < y.m_dead);
+	}
+	if (x.m_lock != y.m_lock) {
+		return (x.m_lock < y.m_lock);
+	}
+	return (x.m_client < y.m_client);
+}
 
 CKeyMap::CKeyMap() :
 	m_numGroups(0),
-	m_composeAcrossGroups(false)
+	m_frozen(false),
+	m_composeAcrossGroups(false),
+	m_keyPlanHits(0),
+	m_keyPlanMisses(0)
 {
 	m_modifierKeyItem.m_id        = kKeyNone;
 	m_modifierKeyItem.m_group     = 0;
@@ -47,8 +139,16 @@ CKeyMap::~CKeyMap()
 void
 CKeyMap::swap(CKeyMap& x)
 {
+	clearKeyPlans();
+	x.clearKeyPlans();
 	m_keyIDMap.swap(x.m_keyIDMap);
+	m_keyIDs.swap(x.m_keyIDs);
+	m_keyEntries.swap(x.m_keyEntries);
+	m_entryItems.swap(x.m_entryItems);
+	m_items.swap(x.m_items);
 	m_modifierKeys.swap(x.m_modifierKeys);
+	m_modifierIndex.swap(x.m_modifierIndex);
+	m_groupModifiers.swap(x.m_groupModifiers);
 	m_halfDuplex.swap(x.m_halfDuplex);
 	m_halfDuplexMods.swap(x.m_halfDuplexMods);
 	SInt32 tmp1   = m_numGroups;
@@ -57,11 +157,18 @@ CKeyMap::swap(CKeyMap& x)
 	bool tmp2               = m_composeAcrossGroups;
 	m_composeAcrossGroups   = x.m_composeAcrossGroups;
 	x.m_composeAcrossGroups = tmp2;
+	bool tmp3  = m_frozen;
+	m_frozen   = x.m_frozen;
+	x.m_frozen = tmp3;
 }
 
 void
 CKeyMap::addKeyEntry(const KeyItem& item)
 {
+	assert(!m_frozen);
+
+	clearKeyPlans();
+
 	// ignore kKeyNone
 	if (item.m_id == kKeyNone) {
 		return;
@@ -109,8 +216,12 @@ CKeyMap::addKeyAliasEntry(KeyID targetID, SInt32 group,
 				KeyModifierMask sourceRequired,
 				KeyModifierMask sourceSensitive)
 {
+	assert(!m_frozen);
+
+	clearKeyPlans();
+
 	// if we can already generate the target as desired then we're done.
-	if (findCompatibleKey(targetID, group, targetRequired,
+	if (findUnfrozenCompatibleKey(targetID, group, targetRequired,
 								targetSensitive) != NULL) {
 		return;
 	}
@@ -119,7 +230,7 @@ CKeyMap::addKeyAliasEntry(KeyID targetID, SInt32 group,
 	for (SInt32 gd = 0, n = getNumGroups(); gd < n; ++gd) {
 		SInt32 eg = getEffectiveGroup(group, gd);
 		const KeyItemList* sourceEntry =
-			findCompatibleKey(sourceID, eg,
+			findUnfrozenCompatibleKey(sourceID, eg,
 								sourceRequired, sourceSensitive);
 		if (sourceEntry != NULL && sourceEntry->size() == 1) {
 			CKeyMap::KeyItem targetItem = sourceEntry->back();
@@ -135,6 +246,10 @@ bool
 CKeyMap::addKeyCombinationEntry(KeyID id, SInt32 group,
 				const KeyID* keys, UInt32 numKeys)
 {
+	assert(!m_frozen);
+
+	clearKeyPlans();
+
 	// disallow kKeyNone
 	if (id == kKeyNone) {
 		return false;
@@ -195,30 +310,36 @@ CKeyMap::addKeyCombinationEntry(KeyID id, SInt32 group,
 void
 CKeyMap::allowGroupSwitchDuringCompose()
 {
+	clearKeyPlans();
 	m_composeAcrossGroups = true;
 }
 
 void
 CKeyMap::addHalfDuplexButton(KeyButton button)
 {
-	m_halfDuplex.insert(button);
+	clearKeyPlans();
+	insertSorted(m_halfDuplex, button);
 }
 
 void
 CKeyMap::clearHalfDuplexModifiers()
 {
+	clearKeyPlans();
 	m_halfDuplexMods.clear();
 }
 
 void
 CKeyMap::addHalfDuplexModifier(KeyID key)
 {
-	m_halfDuplexMods.insert(key);
+	clearKeyPlans();
+	insertSorted(m_halfDuplexMods, key);
 }
 
 void
 CKeyMap::finish()
 {
+	clearKeyPlans();
+
 	m_numGroups = findNumGroups();
 
 	// make sure every key has the same number of groups
@@ -227,6 +348,47 @@ CKeyMap::finish()
 		i->second.resize(m_numGroups);
 	}
 
+	// there are no keys that generate modifiers until we're frozen
+	setModifierKeys();
+}
+
+void
+CKeyMap::freeze()
+{
+	assert(!m_frozen);
+
+	clearKeyPlans();
+
+	// pack the entries.  the map is sorted by KeyID and every key has
+	// m_numGroups groups so the key and group tables are dense.
+	m_keyIDs.clear();
+	m_keyEntries.clear();
+	m_entryItems.clear();
+	m_items.clear();
+	m_keyIDs.reserve(m_keyIDMap.size());
+	m_keyEntries.reserve(m_keyIDMap.size() * m_numGroups + 1);
+	for (KeyIDMap::const_iterator i = m_keyIDMap.begin();
+								i != m_keyIDMap.end(); ++i) {
+		m_keyIDs.push_back(i->first);
+		const KeyGroupTable& groupTable = i->second;
+		for (SInt32 g = 0; g < m_numGroups; ++g) {
+			m_keyEntries.push_back(static_cast<UInt32>(m_entryItems.size()));
+			if (static_cast<size_t>(g) >= groupTable.size()) {
+				continue;
+			}
+			const KeyEntryList& entries = groupTable[g];
+			for (size_t j = 0; j < entries.size(); ++j) {
+				m_entryItems.push_back(static_cast<UInt32>(m_items.size()));
+				m_items.insert(m_items.end(),
+								entries[j].begin(), entries[j].end());
+			}
+		}
+	}
+	m_keyEntries.push_back(static_cast<UInt32>(m_entryItems.size()));
+	m_entryItems.push_back(static_cast<UInt32>(m_items.size()));
+	m_keyIDMap.clear();
+	m_frozen = true;
+
 	// compute keys that generate each modifier
 	setModifierKeys();
 }
@@ -234,6 +396,22 @@ CKeyMap::finish()
 void
 CKeyMap::foreachKey(ForeachKeyCallback cb, void* userData)
 {
+	clearKeyPlans();
+
+	if (m_frozen) {
+		for (size_t k = 0; k < m_keyIDs.size(); ++k) {
+			for (SInt32 g = 0; g < m_numGroups; ++g) {
+				UInt32 first, last;
+				getKeyEntries(static_cast<SInt32>(k), g, first, last);
+				for (UInt32 j = m_entryItems[first];
+								j < m_entryItems[last]; ++j) {
+					(*cb)(m_keyIDs[k], g, m_items[j], userData);
+				}
+			}
+		}
+		return;
+	}
+
 	for (KeyIDMap::iterator i = m_keyIDMap.begin();
 								i != m_keyIDMap.end(); ++i) {
 		KeyGroupTable& groupTable = i->second;
@@ -269,6 +447,52 @@ CKeyMap::mapKey(Keystrokes& keys, KeyID id, SInt32 group,
 		return NULL;
 	}
 
+	// the result depends only on the arguments and the map so use the
+	// previous result if we've mapped exactly this before.
+	KeyPlanKey planKey;
+	planKey.m_id              = id;
+	planKey.m_group           = group;
+	planKey.m_currentState    = currentState;
+	planKey.m_desiredMask     = desiredMask;
+	planKey.m_isAutoRepeat    = isAutoRepeat;
+	planKey.m_activeModifiers = activeModifiers;
+	KeyPlanMap::const_iterator i = m_keyPlans.find(planKey);
+	if (i != m_keyPlans.end()) {
+		++m_keyPlanHits;
+		const KeyPlan& plan = i->second;
+		keys.insert(keys.end(), plan.m_keys.begin(), plan.m_keys.end());
+		activeModifiers = plan.m_activeModifiers;
+		currentState    = plan.m_currentState;
+		LOG((CLOG_DEBUG1 "mapped to %03x, new state %04x (memoized)", plan.m_item->m_button, currentState));
+		return plan.m_item;
+	}
+	++m_keyPlanMisses;
+
+	// map the key and save the result.  failures aren't saved since
+	// they may have left partial results.
+	size_t numKeys = keys.size();
+	const KeyItem* item = doMapKey(keys, id, group, activeModifiers,
+							currentState, desiredMask, isAutoRepeat);
+	if (item != NULL) {
+		if (m_keyPlans.size() >= s_maxKeyPlans) {
+			m_keyPlans.clear();
+		}
+		KeyPlan& plan = m_keyPlans[planKey];
+		plan.m_keys.assign(keys.begin() + numKeys, keys.end());
+		plan.m_activeModifiers = activeModifiers;
+		plan.m_currentState    = currentState;
+		plan.m_item            = item;
+	}
+	return item;
+}
+
+const CKeyMap::KeyItem*
+CKeyMap::doMapKey(Keystrokes& keys, KeyID id, SInt32 group,
+				ModifierToKeys& activeModifiers,
+				KeyModifierMask& currentState,
+				KeyModifierMask desiredMask,
+				bool isAutoRepeat) const
+{
 	const KeyItem* item;
 	switch (id) {
 	case kKeyShift_L:
@@ -336,23 +560,24 @@ CKeyMap::getEffectiveGroup(SInt32 group, SInt32 offset) const
 	return (group + offset + getNumGroups()) % getNumGroups();
 }
 
-const CKeyMap::KeyItemList*
+const CKeyMap::KeyItem*
 CKeyMap::findCompatibleKey(KeyID id, SInt32 group,
 				KeyModifierMask required, KeyModifierMask sensitive) const
 {
 	assert(group >= 0 && group < getNumGroups());
 
-    KeyIDMap::const_iterator i = m_keyIDMap.find(id);
-	if (i == m_keyIDMap.end()) {
+	SInt32 k = findKeyIndex(id);
+	if (k == -1) {
 		return NULL;
 	}
 
-	const KeyEntryList& entries = i->second[group];
-	for (size_t j = 0; j < entries.size(); ++j) {
-		if ((entries[j].back().m_sensitive & sensitive) == 0 ||
-			(entries[j].back().m_required & sensitive) ==
-				(required & sensitive)) {
-			return &entries[j];
+	UInt32 first, last;
+	getKeyEntries(k, group, first, last);
+	for (UInt32 e = first; e < last; ++e) {
+		UInt32 n;
+		const KeyItem* items = getEntryItems(e, n);
+		if (n != 0 && isCompatibleKey(items[n - 1], required, sensitive)) {
+			return &items[n - 1];
 		}
 	}
 
@@ -362,7 +587,10 @@ CKeyMap::findCompatibleKey(KeyID id, SInt32 group,
 bool
 CKeyMap::isHalfDuplex(KeyID key, KeyButton button) const
 {
-	return (m_halfDuplex.count(button) + m_halfDuplexMods.count(key) > 0);
+	return (std::binary_search(m_halfDuplex.begin(),
+								m_halfDuplex.end(), button) ||
+			std::binary_search(m_halfDuplexMods.begin(),
+								m_halfDuplexMods.end(), key));
 }
 
 bool
@@ -465,36 +693,51 @@ CKeyMap::findNumGroups() const
 void
 CKeyMap::setModifierKeys()
 {
-	m_modifierKeys.clear();
-	m_modifierKeys.resize(kKeyModifierNumBits * getNumGroups());
-	for (KeyIDMap::const_iterator i = m_keyIDMap.begin();
-								i != m_keyIDMap.end(); ++i) {
-		const KeyGroupTable& groupTable = i->second;
-		for (size_t g = 0; g < groupTable.size(); ++g) {
-			const KeyEntryList& entries = groupTable[g];
-			for (size_t j = 0; j < entries.size(); ++j) {
+	// collect the frozen keys that generate each modifier in each group
+	SInt32 numGroups = getNumGroups();
+	std::vector<ModifierKeyItemList> modifierKeys(
+								kKeyModifierNumBits * numGroups);
+	m_groupModifiers.assign(numGroups, 0);
+	for (size_t k = 0; k < m_keyIDs.size(); ++k) {
+		for (SInt32 g = 0; g < numGroups; ++g) {
+			UInt32 first, last;
+			getKeyEntries(static_cast<SInt32>(k), g, first, last);
+			for (UInt32 e = first; e < last; ++e) {
 				// skip multi-key sequences
-				if (entries[j].size() != 1) {
+				UInt32 n;
+				const KeyItem* item = getEntryItems(e, n);
+				if (n != 1) {
 					continue;
 				}
 
 				// skip keys that don't generate a modifier
-				const KeyItem& item = entries[j].back();
-				if (item.m_generates == 0) {
+				if (item->m_generates == 0) {
 					continue;
 				}
 
 				// add key to each indicated modifier in this group
 				for (SInt32 b = 0; b < kKeyModifierNumBits; ++b) {
 					// skip if item doesn't generate bit b
-					if (((1u << b) & item.m_generates) != 0) {
+					if (((1u << b) & item->m_generates) != 0) {
 						SInt32 mIndex = g * kKeyModifierNumBits + b;
-						m_modifierKeys[mIndex].push_back(&item);
+						modifierKeys[mIndex].push_back(item);
+						m_groupModifiers[g] |= (1u << b);
 					}
 				}
 			}
 		}
 	}
+
+	// pack the lists
+	m_modifierKeys.clear();
+	m_modifierIndex.clear();
+	m_modifierIndex.reserve(modifierKeys.size() + 1);
+	for (size_t i = 0; i < modifierKeys.size(); ++i) {
+		m_modifierIndex.push_back(static_cast<UInt32>(m_modifierKeys.size()));
+		m_modifierKeys.insert(m_modifierKeys.end(),
+								modifierKeys[i].begin(), modifierKeys[i].end());
+	}
+	m_modifierIndex.push_back(static_cast<UInt32>(m_modifierKeys.size()));
 }
 
 const CKeyMap::KeyItem*
@@ -507,22 +750,24 @@ CKeyMap::mapCommandKey(Keystrokes& keys, KeyID id, SInt32 group,
 	static const KeyModifierMask s_overrideModifiers = 0xffffu;
 
 	// find KeySym in table
-	KeyIDMap::const_iterator i = m_keyIDMap.find(id);
-	if (i == m_keyIDMap.end()) {
+	SInt32 k = findKeyIndex(id);
+	if (k == -1) {
 		// unknown key
 		LOG((CLOG_DEBUG1 "key %04x is not on keyboard", id));
 		return NULL;
 	}
-	const KeyGroupTable& keyGroupTable = i->second;
 
 	// find the first key that generates this KeyID
 	const KeyItem* keyItem = NULL;
 	SInt32 numGroups       = getNumGroups();
 	for (SInt32 groupOffset = 0; groupOffset < numGroups; ++groupOffset) {
 		SInt32 effectiveGroup = getEffectiveGroup(group, groupOffset);
-		const KeyEntryList& entryList = keyGroupTable[effectiveGroup];
-		for (size_t i = 0; i < entryList.size(); ++i) {
-			if (entryList[i].size() != 1) {
+		UInt32 first, last;
+		getKeyEntries(k, effectiveGroup, first, last);
+		for (UInt32 e = first; e < last; ++e) {
+			UInt32 n;
+			const KeyItem* items = getEntryItems(e, n);
+			if (n != 1) {
 				// ignore multikey entries
 				continue;
 			}
@@ -531,7 +776,7 @@ CKeyMap::mapCommandKey(Keystrokes& keys, KeyID id, SInt32 group,
 			// not the right character.  we'll use desiredMask as-is,
 			// overriding the key's required modifiers, when synthesizing
 			// this button.
-			const KeyItem& item = entryList[i].back();
+			const KeyItem& item = items[0];
 			if ((item.m_required & KeyModifierShift & desiredMask) ==
 				(item.m_sensitive & KeyModifierShift & desiredMask)) {
 				LOG((CLOG_DEBUG1 "found key in group %d", effectiveGroup));
@@ -595,13 +840,12 @@ CKeyMap::mapCharacterKey(Keystrokes& keys, KeyID id, SInt32 group,
 				bool isAutoRepeat) const
 {
 	// find KeySym in table
-	KeyIDMap::const_iterator i = m_keyIDMap.find(id);
-	if (i == m_keyIDMap.end()) {
+	SInt32 k = findKeyIndex(id);
+	if (k == -1) {
 		// unknown key
 		LOG((CLOG_DEBUG1 "key %04x is not on keyboard", id));
 		return NULL;
 	}
-	const KeyGroupTable& keyGroupTable = i->second;
 
 	// find best key in any group, starting with the active group
 	SInt32 keyIndex  = -1;
@@ -610,8 +854,9 @@ CKeyMap::mapCharacterKey(Keystrokes& keys, KeyID id, SInt32 group,
 	LOG((CLOG_DEBUG1 "find best:  %04x %04x", currentState, desiredMask));
 	for (groupOffset = 0; groupOffset < numGroups; ++groupOffset) {
 		SInt32 effectiveGroup = getEffectiveGroup(group, groupOffset);
-		keyIndex = findBestKey(keyGroupTable[effectiveGroup],
-								currentState, desiredMask);
+		UInt32 first, last;
+		getKeyEntries(k, effectiveGroup, first, last);
+		keyIndex = findBestKey(first, last, currentState, desiredMask);
 		if (keyIndex != -1) {
 			LOG((CLOG_DEBUG1 "found key in group %d", effectiveGroup));
 			break;
@@ -624,12 +869,12 @@ CKeyMap::mapCharacterKey(Keystrokes& keys, KeyID id, SInt32 group,
 	}
 
 	// get keys to press for key
-	SInt32 effectiveGroup = getEffectiveGroup(group, groupOffset);
-	const KeyItemList& itemList = keyGroupTable[effectiveGroup][keyIndex];
-	if (itemList.empty()) {
+	UInt32 numItems;
+	const KeyItem* items = getEntryItems(keyIndex, numItems);
+	if (numItems == 0) {
 		return NULL;
 	}
-	const KeyItem& keyItem = itemList.back();
+	const KeyItem& keyItem = items[numItems - 1];
 
 	// make working copy of modifiers
 	ModifierToKeys newModifiers = activeModifiers;
@@ -637,8 +882,8 @@ CKeyMap::mapCharacterKey(Keystrokes& keys, KeyID id, SInt32 group,
 	SInt32 newGroup             = group;
 
 	// add each key
-	for (size_t j = 0; j < itemList.size(); ++j) {
-		if (!keysForKeyItem(itemList[j], newGroup, newModifiers,
+	for (UInt32 j = 0; j < numItems; ++j) {
+		if (!keysForKeyItem(items[j], newGroup, newModifiers,
 							newState, desiredMask,
 							0, isAutoRepeat, keys)) {
 			LOG((CLOG_DEBUG1 "can't map key"));
@@ -679,16 +924,16 @@ CKeyMap::mapModifierKey(Keystrokes& keys, KeyID id, SInt32 group,
 }
 
 SInt32
-CKeyMap::findBestKey(const KeyEntryList& entryList,
+CKeyMap::findBestKey(UInt32 first, UInt32 last,
 				KeyModifierMask /*currentState*/,
 				KeyModifierMask desiredState) const
 {
 	// check for an item that can accommodate the desiredState exactly
-	for (size_t i = 0; i < entryList.size(); ++i) {
-		const KeyItem& item = entryList[i].back();
+	for (UInt32 i = first; i < last; ++i) {
+		const KeyItem& item = m_items[m_entryItems[i + 1] - 1];
 		if ((item.m_required & desiredState) ==
 			(item.m_sensitive & desiredState)) {
-			LOG((CLOG_DEBUG1 "best key index %d of %d (exact)", i, entryList.size()));
+			LOG((CLOG_DEBUG1 "best key index %d of %d (exact)", i - first, last - first));
 			return i;
 		}
 	}
@@ -696,8 +941,8 @@ CKeyMap::findBestKey(const KeyEntryList& entryList,
 	// choose the item that requires the fewest modifier changes
 	SInt32 bestCount = 32;
 	SInt32 bestIndex = -1;
-	for (size_t i = 0; i < entryList.size(); ++i) {
-		const KeyItem& item = entryList[i].back();
+	for (UInt32 i = first; i < last; ++i) {
+		const KeyItem& item = m_items[m_entryItems[i + 1] - 1];
 		KeyModifierMask change =
 			((item.m_required ^ desiredState) & item.m_sensitive);
 		SInt32 n = getNumModifiers(change);
@@ -707,7 +952,7 @@ CKeyMap::findBestKey(const KeyEntryList& entryList,
 		}
 	}
 	if (bestIndex != -1) {
-		LOG((CLOG_DEBUG1 "best key index %d of %d (%d modifiers)", bestIndex, entryList.size(), bestCount));
+		LOG((CLOG_DEBUG1 "best key index %d of %d (%d modifiers)", bestIndex - first, last - first, bestCount));
 	}
 
 	return bestIndex;
@@ -726,12 +971,14 @@ CKeyMap::keyForModifier(KeyButton button, SInt32 group,
 	// to generate a KeyID that's only bound the the given button.
 	// this is important when a shift button is modified by shift;  we
 	// must use the other shift button to do the shifting.
-	const ModifierKeyItemList& items =
-		m_modifierKeys[group * kKeyModifierNumBits + modifierBit];
-	for (ModifierKeyItemList::const_iterator i = items.begin();
-								i != items.end(); ++i) {
-		if ((*i)->m_button != button) {
-			return (*i);
+	if ((m_groupModifiers[group] & (1u << modifierBit)) == 0) {
+		return NULL;
+	}
+	SInt32 mIndex = group * kKeyModifierNumBits + modifierBit;
+	for (UInt32 i = m_modifierIndex[mIndex];
+								i < m_modifierIndex[mIndex + 1]; ++i) {
+		if (m_modifierKeys[i]->m_button != button) {
+			return m_modifierKeys[i];
 		}
 	}
 	return NULL;
@@ -1016,7 +1263,8 @@ CKeyMap::addKeystrokes(EKeystroke type, const KeyItem& keyItem,
 	case kKeystrokeUnmodify:
 		if (keyItem.m_lock) {
 			// we assume there's just one button for this modifier
-			if (m_halfDuplex.count(button) > 0) {
+			if (std::binary_search(m_halfDuplex.begin(),
+								m_halfDuplex.end(), button)) {
 				if (type == kKeystrokeModify) {
 					// turn half-duplex toggle on (press)
 					keystrokes.push_back(Keystroke(button,  true, false, data));
@@ -1147,14 +1395,22 @@ CKeyMap::formatKey(KeyID key, KeyModifierMask mask)
 	CString x;
 	for (SInt32 i = 0; i < kKeyModifierNumBits; ++i) {
 		KeyModifierMask mod = (1u << i);
-		if ((mask & mod) != 0 && s_modifierToNameMap->count(mod) > 0) {
-			x += s_modifierToNameMap->find(mod)->second;
-			x += "+";
+		if ((mask & mod) == 0) {
+			continue;
+		}
+		for (const KeyModifierNameMapEntry* j = kModifierNameMap;
+								j->m_name != NULL; ++j) {
+			if (j->m_mask == mod) {
+				x += j->m_name;
+				x += "+";
+				break;
+			}
 		}
 	}
 	if (key != kKeyNone) {
-		if (s_keyToNameMap->count(key) > 0) {
-			x += s_keyToNameMap->find(key)->second;
+		const KeyNameMapEntry* entry = findKeyName(key);
+		if (entry != NULL) {
+			x += entry->m_name;
 		}
 		// XXX -- we're assuming ASCII here
 		else if (key >= 33 && key < 127) {
@@ -1179,8 +1435,9 @@ CKeyMap::parseKey(const CString& x, KeyID& key)
 
 	// parse the key
 	key = kKeyNone;
-	if (s_nameToKeyMap->count(x) > 0) {
-		key = s_nameToKeyMap->find(x)->second;
+	const KeyNameMapEntry* entry = findKeyName(x);
+	if (entry != NULL) {
+		key = entry->m_id;
 	}
 	// XXX -- we're assuming ASCII encoding here
 	else if (x.size() == 1) {
@@ -1209,9 +1466,6 @@ CKeyMap::parseKey(const CString& x, KeyID& key)
 bool
 CKeyMap::parseModifiers(CString& x, KeyModifierMask& mask)
 {
-	// initialize tables
-	initKeyNameMaps();
-
 	mask = 0;
 	CString::size_type tb = x.find_first_not_of(" \t", 0);
 	while (tb != CString::npos) {
@@ -1226,8 +1480,15 @@ CKeyMap::parseModifiers(CString& x, KeyModifierMask& mask)
 			return false;
 		}
 
-		if (s_nameToModifierMap->count(c) > 0) {
-			KeyModifierMask mod = s_nameToModifierMap->find(c)->second;
+		// the modifier table is short so just search it
+		const KeyModifierNameMapEntry* j = kModifierNameMap;
+		while (j->m_name != NULL &&
+				compareKeyNames(c.c_str(), j->m_name) != 0) {
+			++j;
+		}
+
+		if (j->m_name != NULL) {
+			KeyModifierMask mod = j->m_mask;
 			if ((mask & mod) != 0) {
 				// modifier appears twice
 				return false;
@@ -1264,27 +1525,108 @@ CKeyMap::parseModifiers(CString& x, KeyModifierMask& mask)
 	return true;
 }
 
+void
+CKeyMap::clearKeyPlans()
+{
+	if (m_keyPlanHits != 0 || m_keyPlanMisses != 0) {
+		LOG((CLOG_DEBUG1 "key plans: %d hits, %d misses", m_keyPlanHits, m_keyPlanMisses));
+		m_keyPlanHits   = 0;
+		m_keyPlanMisses = 0;
+	}
+	m_keyPlans.clear();
+}
+
+const CKeyMap::KeyItemList*
+CKeyMap::findUnfrozenCompatibleKey(KeyID id, SInt32 group,
+				KeyModifierMask required, KeyModifierMask sensitive) const
+{
+	assert(group >= 0 && group < getNumGroups());
+
+	KeyIDMap::const_iterator i = m_keyIDMap.find(id);
+	if (i == m_keyIDMap.end()) {
+		return NULL;
+	}
+
+	const KeyEntryList& entries = i->second[group];
+	for (size_t j = 0; j < entries.size(); ++j) {
+		if (isCompatibleKey(entries[j].back(), required, sensitive)) {
+			return &entries[j];
+		}
+	}
+
+	return NULL;
+}
+
+SInt32
+CKeyMap::findKeyIndex(KeyID id) const
+{
+	KeyList::const_iterator i =
+		std::lower_bound(m_keyIDs.begin(), m_keyIDs.end(), id);
+	if (i == m_keyIDs.end() || *i != id) {
+		return -1;
+	}
+	return static_cast<SInt32>(i - m_keyIDs.begin());
+}
+
+void
+CKeyMap::getKeyEntries(SInt32 k, SInt32 group,
+				UInt32& first, UInt32& last) const
+{
+	SInt32 i = k * m_numGroups + group;
+	first    = m_keyEntries[i];
+	last     = m_keyEntries[i + 1];
+}
+
+const CKeyMap::KeyItem*
+CKeyMap::getEntryItems(UInt32 e, UInt32& n) const
+{
+	n = m_entryItems[e + 1] - m_entryItems[e];
+	return (n == 0) ? NULL : &m_items[m_entryItems[e]];
+}
+
 void
 CKeyMap::initKeyNameMaps()
 {
-	// initialize tables
-	if (s_nameToKeyMap == NULL) {
-		s_nameToKeyMap = new CNameToKeyMap;
-		s_keyToNameMap = new CKeyToNameMap;
+	// initialize tables.  the sorts are stable and lookups take the
+	// last of equal entries so later entries in the table win.
+	if (s_keyNamesByName == NULL) {
+		s_keyNamesByName = new CKeyNameIndex;
 		for (const KeyNameMapEntry* i = kKeyNameMap; i->m_name != NULL; ++i) {
-			(*s_nameToKeyMap)[i->m_name] = i->m_id;
-			(*s_keyToNameMap)[i->m_id]   = i->m_name;
+			s_keyNamesByName->push_back(i);
 		}
+		s_keyNamesByID = new CKeyNameIndex(*s_keyNamesByName);
+		std::stable_sort(s_keyNamesByName->begin(), s_keyNamesByName->end(),
+								&keyNameLess);
+		std::stable_sort(s_keyNamesByID->begin(), s_keyNamesByID->end(),
+								&keyIDLess);
 	}
-	if (s_nameToModifierMap == NULL) {
-		s_nameToModifierMap = new CNameToModifierMap;
-		s_modifierToNameMap = new CModifierToNameMap;
-		for (const KeyModifierNameMapEntry* i = kModifierNameMap;
-								i->m_name != NULL; ++i) {
-			(*s_nameToModifierMap)[i->m_name] = i->m_mask;
-			(*s_modifierToNameMap)[i->m_mask] = i->m_name;
-		}
+}
+
+const KeyNameMapEntry*
+CKeyMap::findKeyName(const CString& name)
+{
+	KeyNameMapEntry key = { name.c_str(), kKeyNone };
+	CKeyNameIndex::const_iterator i =
+		std::upper_bound(s_keyNamesByName->begin(), s_keyNamesByName->end(),
+								&key, &keyNameLess);
+	if (i == s_keyNamesByName->begin() ||
+		compareKeyNames((*(i - 1))->m_name, name.c_str()) != 0) {
+		return NULL;
 	}
+	return *(i - 1);
+}
+
+const KeyNameMapEntry*
+CKeyMap::findKeyName(KeyID id)
+{
+	KeyNameMapEntry key = { NULL, id };
+	CKeyNameIndex::const_iterator i =
+		std::upper_bound(s_keyNamesByID->begin(), s_keyNamesByID->end(),
+								&key, &keyIDLess);
+	if (i == s_keyNamesByID->begin() || (*(i - 1))->m_id != id) {
+		return NULL;
+	}
+	return *(i - 1);
 }
 
 
@@ -1307,6 +1649,36 @@ CKeyMap::KeyItem::operator==(const KeyItem& x) const
 }
 
 
+//
+// CKeyMap::KeyPlanKey
+//
+
+bool
+CKeyMap::KeyPlanKey::operator<(const KeyPlanKey& x) const
+{
+	if (m_id != x.m_id) {
+		return (m_id < x.m_id);
+	}
+	if (m_group != x.m_group) {
+		return (m_group < x.m_group);
+	}
+	if (m_currentState != x.m_currentState) {
+		return (m_currentState < x.m_currentState);
+	}
+	if (m_desiredMask != x.m_desiredMask) {
+		return (m_desiredMask < x.m_desiredMask);
+	}
+	if (m_isAutoRepeat != x.m_isAutoRepeat) {
+		return (m_isAutoRepeat < x.m_isAutoRepeat);
+	}
+	return std::lexicographical_compare(
+							m_activeModifiers.begin(), m_activeModifiers.end(),
+							x.m_activeModifiers.begin(),
+							x.m_activeModifiers.end(),
+							&activeModifierLess);
+}
+
+
 //
 // CKeyMap::Keystroke
 //
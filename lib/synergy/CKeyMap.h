@@ -19,7 +19,6 @@
 #include "CString.h"
 #include "CStringUtil.h"
 #include "stdmap.h"
-#include "stdset.h"
 #include "stdvector.h"
 
 //! Key map
@@ -190,10 +189,20 @@ public:
 
 	//! Finish adding entries
 	/*!
-	Called after adding entries, this does some internal housekeeping.
+	Called after adding the keyboard's entries, this does some internal
+	housekeeping.  Alias and combination entries may still be added.
 	*/
 	void				finish();
 
+	//! Freeze the map
+	/*!
+	Called after finish() and after adding any alias and combination
+	entries, this packs the entries into contiguous arrays for lookup.
+	No entries may be added afterwards and lookups only find entries
+	that were added before freezing.
+	*/
+	void				freeze();
+
 	//! Iterate over all added keys items
 	/*!
 	Calls \p cb for every key item.
@@ -232,14 +241,14 @@ public:
 
 	//! Find key entry compatible with modifiers
 	/*!
-	Returns the \c KeyItemList for the first entry for \p id in group
+	Returns the last \c KeyItem of the first entry for \p id in group
 	\p group that is compatible with the given modifiers, or NULL
 	if there isn't one.  A button list is compatible with a modifiers
 	if it is either insensitive to all modifiers in \p sensitive or
 	it requires the modifiers to be in the state indicated by \p required
 	for every modifier indicated by \p sensitive.
 	*/
-	const KeyItemList*	findCompatibleKey(KeyID id, SInt32 group,
+	const KeyItem*		findCompatibleKey(KeyID id, SInt32 group,
 							KeyModifierMask required,
 							KeyModifierMask sensitive) const;
 
@@ -334,12 +343,22 @@ private:
 	// A list of ways to synthesize a KeyID
 	typedef std::vector<KeyItemList> KeyEntryList;
 
+	// Ways to synthesize a KeyID over multiple keyboard groups
+	typedef std::vector<KeyEntryList> KeyGroupTable;
+
 	// computes the number of groups
 	SInt32				findNumGroups() const;
 
 	// computes the map of modifiers to the keys that generate the modifiers
 	void				setModifierKeys();
 
+	// does the work of mapKey() without using memoized results
+	const KeyItem*		doMapKey(Keystrokes& keys, KeyID id, SInt32 group,
+							ModifierToKeys& activeModifiers,
+							KeyModifierMask& currentState,
+							KeyModifierMask desiredMask,
+							bool isAutoRepeat) const;
+
 	// maps a command key.  a command key is a keyboard shortcut and we're
 	// trying to synthesize a button press with an exact sets of modifiers,
 	// not trying to synthesize a character.  so we just need to find the
@@ -371,10 +390,10 @@ private:
 							KeyModifierMask desiredMask,
 							bool isAutoRepeat) const;
 
-	// returns the index into \p entryList of the KeyItemList requiring
-	// the fewest modifier changes between \p currentState and
-	// \p desiredState.
-	SInt32				findBestKey(const KeyEntryList& entryList,
+	// returns the index of the frozen entry from \p first up to but not
+	// including \p last requiring the fewest modifier changes between
+	// \p currentState and \p desiredState.
+	SInt32				findBestKey(UInt32 first, UInt32 last,
 							KeyModifierMask currentState,
 							KeyModifierMask desiredState) const;
 
@@ -429,63 +448,133 @@ private:
 							KeyModifierMask& currentState,
 							Keystrokes& keystrokes) const;
 
+	// Like findCompatibleKey() but searches the entries that haven't
+	// been frozen yet.
+	const KeyItemList*	findUnfrozenCompatibleKey(KeyID id, SInt32 group,
+							KeyModifierMask required,
+							KeyModifierMask sensitive) const;
+
+	// Returns the index of \p id in the frozen keys or -1 if it's not
+	// there.
+	SInt32				findKeyIndex(KeyID id) const;
+
+	// Sets \p first and \p last to the range of frozen entries for the
+	// key at index \p k in group \p group.
+	void				getKeyEntries(SInt32 k, SInt32 group,
+							UInt32& first, UInt32& last) const;
+
+	// Returns the items of frozen entry \p e and sets \p n to the
+	// number of items.
+	const KeyItem*		getEntryItems(UInt32 e, UInt32& n) const;
+
 	// Returns the number of modifiers indicated in \p state.
 	static SInt32		getNumModifiers(KeyModifierMask state);
 
+	// Discards memoized mapKey() results.  Must be called whenever the
+	// map changes.
+	void				clearKeyPlans();
+
 	// Initialize key name/id maps
 	static void			initKeyNameMaps();
 
+	// Look up key names
+	static const KeyNameMapEntry*	findKeyName(const CString& name);
+	static const KeyNameMapEntry*	findKeyName(KeyID id);
+
 	// not implemented
 	CKeyMap(const CKeyMap&);
 	CKeyMap&			operator=(const CKeyMap&);
 
 private:
-	// Ways to synthesize a KeyID over multiple keyboard groups
-	typedef std::vector<KeyEntryList> KeyGroupTable;
-
 	// Table of KeyID to ways to synthesize that KeyID
 	typedef std::map<KeyID, KeyGroupTable> KeyIDMap;
 
 	// List of KeyItems that generate a particular modifier
 	typedef std::vector<const KeyItem*> ModifierKeyItemList;
 
-	// Map a modifier to the KeyItems that synthesize that modifier
-	typedef std::vector<ModifierKeyItemList> ModifierToKeyTable;
+	// A list of indexes into another list
+	typedef std::vector<UInt32> IndexList;
+
+	// A list of modifier masks
+	typedef std::vector<KeyModifierMask> ModifierMaskList;
+
+	// A sorted list of keys
+	typedef std::vector<KeyID> KeyList;
+
+	// A sorted list of buttons
+	typedef std::vector<KeyButton> KeyButtonList;
 
-	// A set of keys
-	typedef std::set<KeyID> KeySet;
+	// The arguments to mapKey()
+	class KeyPlanKey {
+	public:
+		bool			operator<(const KeyPlanKey&) const;
+
+	public:
+		KeyID			m_id;
+		SInt32			m_group;
+		KeyModifierMask	m_currentState;
+		KeyModifierMask	m_desiredMask;
+		bool			m_isAutoRepeat;
+		ModifierToKeys	m_activeModifiers;
+	};
 
-	// A set of buttons
-	typedef std::set<KeyButton> KeyButtonSet;
+	// The results of mapKey()
+	class KeyPlan {
+	public:
+		Keystrokes		m_keys;
+		ModifierToKeys	m_activeModifiers;
+		KeyModifierMask	m_currentState;
+		const KeyItem*	m_item;
+	};
 
-	// Key maps for parsing/formatting
-	typedef std::map<CString, KeyID,
-							CStringUtil::CaselessCmp> CNameToKeyMap;
-	typedef std::map<CString, KeyModifierMask,
-							CStringUtil::CaselessCmp> CNameToModifierMap;
-	typedef std::map<KeyID, CString> CKeyToNameMap;
-	typedef std::map<KeyModifierMask, CString> CModifierToNameMap;
+	// Memoized mapKey() results
+	typedef std::map<KeyPlanKey, KeyPlan> KeyPlanMap;
 
-	// KeyID info
+	// Index into kKeyNameMap for parsing/formatting
+	typedef std::vector<const KeyNameMapEntry*> CKeyNameIndex;
+
+	// KeyID info.  entries are added to m_keyIDMap and freeze() moves
+	// them to the frozen tables.
 	KeyIDMap			m_keyIDMap;
 	SInt32				m_numGroups;
-	ModifierToKeyTable	m_modifierKeys;
+	bool				m_frozen;
+
+	// frozen KeyID info.  m_keyIDs is sorted.  the entries for the key
+	// at index k in group g are m_keyEntries[k * m_numGroups + g] up to
+	// but not including the next element.  likewise the items for entry
+	// e are m_entryItems[e] up to m_entryItems[e + 1] in m_items.
+	KeyList				m_keyIDs;
+	IndexList			m_keyEntries;
+	IndexList			m_entryItems;
+	KeyItemList			m_items;
+
+	// keys that generate modifiers.  the keys for modifier bit b in
+	// group g are m_modifierIndex[g * kKeyModifierNumBits + b] up to but
+	// not including the next element in m_modifierKeys.  bit b of
+	// m_groupModifiers[g] is set iff there are any.
+	ModifierKeyItemList	m_modifierKeys;
+	IndexList			m_modifierIndex;
+	ModifierMaskList	m_groupModifiers;
 
 	// composition info
 	bool				m_composeAcrossGroups;
 
 	// half-duplex info
-	KeyButtonSet		m_halfDuplex;			// half-duplex set by synergy
-	KeySet				m_halfDuplexMods;		// half-duplex set by user
+	KeyButtonList		m_halfDuplex;			// half-duplex set by synergy
+	KeyList				m_halfDuplexMods;		// half-duplex set by user
 
 	// dummy KeyItem for changing modifiers
 	KeyItem				m_modifierKeyItem;
 
-	// parsing/formatting tables
-	static CNameToKeyMap*		s_nameToKeyMap;
-	static CNameToModifierMap*	s_nameToModifierMap;
-	static CKeyToNameMap*		s_keyToNameMap;
-	static CModifierToNameMap*	s_modifierToNameMap;
+	// memoized mapKey() results and their hit/miss counts
+	mutable KeyPlanMap	m_keyPlans;
+	mutable UInt32		m_keyPlanHits;
+	mutable UInt32		m_keyPlanMisses;
+
+	// parsing/formatting tables.  these are kKeyNameMap sorted by
+	// name (ignoring case) and by KeyID for binary searching.
+	static CKeyNameIndex*		s_keyNamesByName;
+	static CKeyNameIndex*		s_keyNamesByID;
 };
 
 #endif
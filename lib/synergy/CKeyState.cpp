@@ -461,6 +461,9 @@ CKeyState::updateKeyMap()
 	addCombinationEntries();
 	addKeypadEntries();
 	addAliasEntries();
+
+	// pack the map for lookup
+	m_keyMap.freeze();
 }
 
 void
@@ -719,13 +722,13 @@ CKeyState::isIgnoredKey(KeyID key, KeyModifierMask) const
 KeyButton
 CKeyState::getButton(KeyID id, SInt32 group) const
 {
-	const CKeyMap::KeyItemList* items =
+	const CKeyMap::KeyItem* item =
 		m_keyMap.findCompatibleKey(id, group, 0, 0);
-	if (items == NULL) {
+	if (item == NULL) {
 		return 0;
 	}
 	else {
-		return items->back().m_button;
+		return item->m_button;
 	}
 }
 
@@ -75,6 +75,14 @@ CPlatformScreen::fakeCtrlAltDel()
 	return getKeyState()->fakeCtrlAltDel();
 }
 
+bool
+CPlatformScreen::getClipboardFormats(ClipboardID id,
+				IClipboard* clipboard, UInt32) const
+{
+	// convert every format
+	return getClipboard(id, clipboard);
+}
+
 bool
 CPlatformScreen::isKeyDown(KeyButton button) const
 {
@@ -86,6 +86,8 @@ public:
 	virtual void		setOptions(const COptionsList& options) = 0;
 	virtual void		setSequenceNumber(UInt32) = 0;
 	virtual bool		isPrimary() const = 0;
+	virtual bool		getClipboardFormats(ClipboardID, IClipboard*,
+							UInt32 formats) const;
 
 protected:
 	//! Update mouse buttons
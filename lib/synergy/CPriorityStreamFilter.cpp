@@ -0,0 +1,203 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "CPriorityStreamFilter.h"
+#include "ProtocolTypes.h"
+#include "CLock.h"
+#include "CLog.h"
+#include "CArch.h"
+#include <cstring>
+
+//
+// CPriorityStreamFilter
+//
+
+// unflushed interactive bytes above which mouse motion is coalesced.
+// a motion message is 8 bytes.
+static const UInt32		s_motionHighWater = 1024;
+
+CPriorityStreamFilter::CPriorityStreamFilter(IStream* stream,
+				bool adoptStream) :
+	CStreamFilter(stream, adoptStream)
+{
+	for (int lane = 0; lane < kNumLanes; ++lane) {
+		m_size[lane]  = 0;
+		m_since[lane] = 0.0;
+	}
+}
+
+CPriorityStreamFilter::~CPriorityStreamFilter()
+{
+	// do nothing
+}
+
+void
+CPriorityStreamFilter::close()
+{
+	CLock lock(&m_mutex);
+	m_motion.erase();
+	for (int lane = 0; lane < kNumLanes; ++lane) {
+		m_size[lane] = 0;
+	}
+	CStreamFilter::close();
+}
+
+void
+CPriorityStreamFilter::write(const void* buffer, UInt32 n)
+{
+	CLock lock(&m_mutex);
+
+	// merge mouse motion into held motion.  the held motion is
+	// already accounted for.
+	const ELane lane = getLane(buffer, n);
+	const bool motion = (lane == kInteractive && isMotion(buffer, n));
+	if (motion && mergeMotion(buffer, n)) {
+		return;
+	}
+
+	// account for the message
+	if (m_size[lane] == 0) {
+		m_since[lane] = ARCH->coarseTime();
+	}
+	m_size[lane] += n;
+
+	// messages go straight through, except that motion is held while
+	// the output is backed up so later motion can replace it.  held
+	// motion must go out before any other message to keep the order
+	// of motion, buttons and keys.
+	sendMotion();
+	if (motion && m_size[kInteractive] > s_motionHighWater) {
+		m_motion.assign(reinterpret_cast<const char*>(buffer), n);
+	}
+	else {
+		getStream()->write(buffer, n);
+	}
+}
+
+void
+CPriorityStreamFilter::flush()
+{
+	{
+		CLock lock(&m_mutex);
+		sendMotion();
+	}
+	CStreamFilter::flush();
+}
+
+void
+CPriorityStreamFilter::shutdownOutput()
+{
+	{
+		CLock lock(&m_mutex);
+		sendMotion();
+	}
+	CStreamFilter::shutdownOutput();
+}
+
+void
+CPriorityStreamFilter::filterEvent(const CEvent& event)
+{
+	if (event.getType() == getOutputFlushedEvent()) {
+		CLock lock(&m_mutex);
+
+		// everything we wrote has been flushed.  report how much each
+		// lane held and how long its oldest message waited.
+		if (CLOG->getFilter() >= CLog::kDEBUG2) {
+			const double now = ARCH->coarseTime();
+			LOG((CLOG_DEBUG2 "flushed interactive %d bytes in %.3fs, bulk %d bytes in %.3fs", m_size[kInteractive], m_size[kInteractive] == 0 ? 0.0 : now - m_since[kInteractive], m_size[kBulk], m_size[kBulk] == 0 ? 0.0 : now - m_since[kBulk]));
+		}
+		m_size[kInteractive] = 0;
+		m_size[kBulk]        = 0;
+
+		// send the latest held motion
+		if (!m_motion.empty()) {
+			m_size[kInteractive]  = m_motion.size();
+			m_since[kInteractive] = ARCH->coarseTime();
+			sendMotion();
+		}
+	}
+
+	// pass event
+	CStreamFilter::filterEvent(event);
+}
+
+CPriorityStreamFilter::ELane
+CPriorityStreamFilter::getLane(const void* buffer, UInt32 n)
+{
+	// kMsgDClipboardFormats chunks are the only bulk traffic.  they're
+	// paced by CClipboardTransfer.  kMsgDClipboard is sent whole on
+	// entering a screen and keys typed right after must see the new
+	// clipboard, so it counts as interactive.
+	if (n >= 4 && memcmp(buffer, kMsgDClipboardFormats, 4) == 0) {
+		return kBulk;
+	}
+	return kInteractive;
+}
+
+bool
+CPriorityStreamFilter::isMotion(const void* buffer, UInt32 n)
+{
+	return (n == 8 && (memcmp(buffer, kMsgDMouseMove, 4) == 0 ||
+						memcmp(buffer, kMsgDMouseRelMove, 4) == 0));
+}
+
+bool
+CPriorityStreamFilter::mergeMotion(const void* buffer, UInt32 n)
+{
+	// note -- m_mutex must be locked on entry
+
+	if (m_motion.empty() || memcmp(m_motion.data(), buffer, 4) != 0) {
+		return false;
+	}
+
+	// absolute motion replaces the held position
+	const UInt8* src = reinterpret_cast<const UInt8*>(buffer);
+	if (memcmp(buffer, kMsgDMouseMove, 4) == 0) {
+		m_motion.assign(reinterpret_cast<const char*>(src), n);
+		return true;
+	}
+
+	// relative motion adds to the held motion if it fits
+	SInt32 dx = readSInt16(m_motion.data() + 4) +
+				readSInt16(reinterpret_cast<const char*>(src + 4));
+	SInt32 dy = readSInt16(m_motion.data() + 6) +
+				readSInt16(reinterpret_cast<const char*>(src + 6));
+	if (dx < -32768 || dx > 32767 || dy < -32768 || dy > 32767) {
+		return false;
+	}
+	m_motion[4] = static_cast<char>((dx >> 8) & 0xff);
+	m_motion[5] = static_cast<char>( dx       & 0xff);
+	m_motion[6] = static_cast<char>((dy >> 8) & 0xff);
+	m_motion[7] = static_cast<char>( dy       & 0xff);
+	return true;
+}
+
+void
+CPriorityStreamFilter::sendMotion()
+{
+	// note -- m_mutex must be locked on entry
+
+	if (!m_motion.empty()) {
+		getStream()->write(m_motion.data(), m_motion.size());
+		m_motion.erase();
+	}
+}
+
+SInt32
+CPriorityStreamFilter::readSInt16(const char* buffer)
+{
+	const UInt8* ubuffer = reinterpret_cast<const UInt8*>(buffer);
+	return static_cast<SInt16>((static_cast<UInt16>(ubuffer[0]) << 8) |
+								static_cast<UInt16>(ubuffer[1]));
+}
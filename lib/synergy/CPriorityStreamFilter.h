@@ -0,0 +1,86 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef CPRIORITYSTREAMFILTER_H
+#define CPRIORITYSTREAMFILTER_H
+
+#include "CStreamFilter.h"
+#include "CString.h"
+#include "CMutex.h"
+
+//! Prioritizing stream filter
+/*!
+Filters a stream of protocol messages into two output lanes.  Each
+write must be exactly one message, as written by CProtocolUtil, and
+the filtered stream must preserve message boundaries (e.g. a
+CPacketStreamFilter).
+
+Replies carrying requested clipboard formats go in the bulk lane.
+Everything else, notably input events and whole clipboards sent on
+entering a screen, goes in the interactive lane.  Messages are written
+through in order.  Bulk replies are paced by CClipboardTransfer, which
+writes the next chunk only after the stream has flushed, so at most
+one chunk is ever ahead of an interactive message.  The bytes and
+delay of each lane are logged at CLOG_DEBUG2 when the filtered stream
+flushes.
+
+When the filtered stream falls behind, mouse motion is held instead of
+written.  Later absolute motion replaces the held motion and later
+relative motion is added to it, so a slow connection gets the latest
+position rather than an ever growing backlog.  Held motion is written
+when the stream is flushed or before the next message that isn't
+motion of the same kind.
+*/
+class CPriorityStreamFilter : public CStreamFilter {
+public:
+	//! Output lanes
+	enum ELane {
+		kInteractive,
+		kBulk,
+		kNumLanes
+	};
+
+	CPriorityStreamFilter(IStream* stream, bool adoptStream = true);
+	~CPriorityStreamFilter();
+
+	// IStream overrides
+	virtual void		close();
+	virtual void		write(const void* buffer, UInt32 n);
+	virtual void		flush();
+	virtual void		shutdownOutput();
+
+protected:
+	// CStreamFilter overrides
+	virtual void		filterEvent(const CEvent&);
+
+private:
+	static ELane		getLane(const void* buffer, UInt32 n);
+	static bool			isMotion(const void* buffer, UInt32 n);
+	static SInt32		readSInt16(const char* buffer);
+
+	bool				mergeMotion(const void* buffer, UInt32 n);
+	void				sendMotion();
+
+private:
+	CMutex				m_mutex;
+
+	// mouse motion held while the filtered stream is behind, or empty
+	CString				m_motion;
+
+	// unflushed bytes per lane and when the oldest of them was written
+	UInt32				m_size[kNumLanes];
+	double				m_since[kNumLanes];
+};
+
+#endif
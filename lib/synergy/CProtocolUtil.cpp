@@ -46,12 +46,13 @@ CProtocolUtil::readf(IStream* stream, const char* fmt, ...)
 	assert(fmt != NULL);
 	LOG((CLOG_DEBUG2 "readf(%s)", fmt));
 
+	// vreadf() reports a short read or mismatch by returning false.
+	// the stream may still throw.
 	bool result;
 	va_list args;
 	va_start(args, fmt);
 	try {
-		vreadf(stream, fmt, args);
-		result = true;
+		result = vreadf(stream, fmt, args);
 	}
 	catch (XIO&) {
 		result = false;
@@ -89,7 +90,7 @@ CProtocolUtil::vwritef(IStream* stream,
 	}
 }
 
-void
+bool
 CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 {
 	assert(stream != NULL);
@@ -108,7 +109,9 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 
 				// read the data
 				UInt8 buffer[4];
-				read(stream, buffer, len);
+				if (!read(stream, buffer, len)) {
+					return false;
+				}
 
 				// convert it
 				void* v = va_arg(args, void*);
@@ -147,7 +150,9 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 
 				// read the vector length
 				UInt8 buffer[4];
-				read(stream, buffer, 4);
+				if (!read(stream, buffer, 4)) {
+					return false;
+				}
 				UInt32 n = (static_cast<UInt32>(buffer[0]) << 24) |
 						   (static_cast<UInt32>(buffer[1]) << 16) |
 						   (static_cast<UInt32>(buffer[2]) <<  8) |
@@ -159,7 +164,9 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 				case 1:
 					// 1 byte integer
 					for (UInt32 i = 0; i < n; ++i) {
-						read(stream, buffer, 1);
+						if (!read(stream, buffer, 1)) {
+							return false;
+						}
 						reinterpret_cast<std::vector<UInt8>*>(v)->push_back(
 							buffer[0]);
 						LOG((CLOG_DEBUG2 "readf: read %d byte integer[%d]: %d (0x%x)", len, i, reinterpret_cast<std::vector<UInt8>*>(v)->back(), reinterpret_cast<std::vector<UInt8>*>(v)->back()));
@@ -169,7 +176,9 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 				case 2:
 					// 2 byte integer
 					for (UInt32 i = 0; i < n; ++i) {
-						read(stream, buffer, 2);
+						if (!read(stream, buffer, 2)) {
+							return false;
+						}
 						reinterpret_cast<std::vector<UInt16>*>(v)->push_back(
 							static_cast<UInt16>(
 							(static_cast<UInt16>(buffer[0]) << 8) |
@@ -181,7 +190,9 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 				case 4:
 					// 4 byte integer
 					for (UInt32 i = 0; i < n; ++i) {
-						read(stream, buffer, 4);
+						if (!read(stream, buffer, 4)) {
+							return false;
+						}
 						reinterpret_cast<std::vector<UInt32>*>(v)->push_back(
 							(static_cast<UInt32>(buffer[0]) << 24) |
 							(static_cast<UInt32>(buffer[1]) << 16) |
@@ -199,7 +210,9 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 
 				// read the string length
 				UInt8 buffer[128];
-				read(stream, buffer, 4);
+				if (!read(stream, buffer, 4)) {
+					return false;
+				}
 				UInt32 len = (static_cast<UInt32>(buffer[0]) << 24) |
 							 (static_cast<UInt32>(buffer[1]) << 16) |
 							 (static_cast<UInt32>(buffer[2]) <<  8) |
@@ -215,8 +228,9 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 				}
 
 				// read the data
+				bool success;
 				try {
-					read(stream, sBuffer, len);
+					success = read(stream, sBuffer, len);
 				}
 				catch (...) {
 					if (!useFixed) {
@@ -224,6 +238,12 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 					}
 					throw;
 				}
+				if (!success) {
+					if (!useFixed) {
+						delete[] sBuffer;
+					}
+					return false;
+				}
 				LOG((CLOG_DEBUG2 "readf: read %d byte string: %.*s", len, len, sBuffer));
 
 				// save the data
@@ -251,18 +271,21 @@ CProtocolUtil::vreadf(IStream* stream, const char* fmt, va_list args)
 		else {
 			// read next character
 			char buffer[1];
-			read(stream, buffer, 1);
+			if (!read(stream, buffer, 1)) {
+				return false;
+			}
 
 			// verify match
 			if (buffer[0] != *fmt) {
 				LOG((CLOG_DEBUG2 "readf: format mismatch: %c vs %c", *fmt, buffer[0]));
-				throw XIOReadMismatch();
+				return false;
 			}
 
 			// next format character
 			++fmt;
 		}
 	}
+	return true;
 }
 
 UInt32
@@ -503,7 +526,7 @@ CProtocolUtil::eatLength(const char** pfmt)
 	}
 }
 
-void
+bool
 CProtocolUtil::read(IStream* stream, void* vbuffer, UInt32 count)
 {
 	assert(stream != NULL);
@@ -517,22 +540,12 @@ CProtocolUtil::read(IStream* stream, void* vbuffer, UInt32 count)
 		// bail if stream has hungup
 		if (n == 0) {
 			LOG((CLOG_DEBUG2 "unexpected disconnect in readf(), %d bytes left", count));
-			throw XIOEndOfStream();
+			return false;
 		}
 
 		// prepare for next read
 		buffer += n;
 		count  -= n;
 	}
-}
-
-
-//
-// XIOReadMismatch
-//
-
-CString
-XIOReadMismatch::getWhat() const throw()
-{
-	return format("XIOReadMismatch", "CProtocolUtil::readf() mismatch");
+	return true;
 }
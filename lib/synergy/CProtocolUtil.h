@@ -71,24 +71,13 @@ public:
 private:
 	static void			vwritef(IStream*,
 							const char* fmt, UInt32 size, va_list);
-	static void			vreadf(IStream*,
+	static bool			vreadf(IStream*,
 							const char* fmt, va_list);
 
 	static UInt32		getLength(const char* fmt, va_list);
 	static void			writef(void*, const char* fmt, va_list);
 	static UInt32		eatLength(const char** fmt);
-	static void			read(IStream*, void*, UInt32);
-};
-
-//! Mismatched read exception
-/*!
-Thrown by CProtocolUtil::readf() when the data being read does not
-match the format.
-*/
-class XIOReadMismatch : public XIO {
-public:
-	// XBase overrides
-	virtual CString		getWhat() const throw();
+	static bool			read(IStream*, void*, UInt32);
 };
 
 #endif
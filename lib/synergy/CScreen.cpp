@@ -397,6 +397,13 @@ CScreen::pollActiveModifiers() const
 	return m_screen->pollActiveModifiers();
 }
 
+bool
+CScreen::getClipboardFormats(ClipboardID id,
+				IClipboard* clipboard, UInt32 formats) const
+{
+	return m_screen->getClipboardFormats(id, clipboard, formats);
+}
+
 void*
 CScreen::getEventTarget() const
 {
@@ -257,6 +257,15 @@ public:
 	*/
 	KeyModifierMask		pollActiveModifiers() const;
 
+	//! Get some clipboard formats
+	/*!
+	Like getClipboard() except only formats whose bit (1 << format) is
+	set in \c formats need be converted.  Other available formats may
+	be added as deferred.
+	*/
+	bool				getClipboardFormats(ClipboardID, IClipboard*,
+							UInt32 formats) const;
+
 	//@}
 
 	// IScreen overrides
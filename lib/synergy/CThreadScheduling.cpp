@@ -0,0 +1,135 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#include "CThreadScheduling.h"
+#include "CString.h"
+#include "CLog.h"
+#include "CArch.h"
+#include <cstdlib>
+#include <cstring>
+
+//
+// CThreadScheduling
+//
+
+CThreadScheduling::CThreadScheduling() :
+	m_setPolicy(false),
+	m_policy(IArchMultithread::kSchedulingNormal),
+	m_priority(0),
+	m_lockMemory(false)
+{
+	// do nothing
+}
+
+CThreadScheduling::~CThreadScheduling()
+{
+	// do nothing
+}
+
+bool
+CThreadScheduling::parsePolicy(const char* arg)
+{
+	// policy
+	const char* colon = strchr(arg, ':');
+	CString policy(arg, (colon == NULL) ? strlen(arg) : colon - arg);
+	IArchMultithread::ESchedulingPolicy schedulingPolicy;
+	int priority;
+	if (policy == "normal") {
+		schedulingPolicy = IArchMultithread::kSchedulingNormal;
+		priority         = -10;
+	}
+	else if (policy == "rr") {
+		schedulingPolicy = IArchMultithread::kSchedulingRoundRobin;
+		priority         = 10;
+	}
+	else if (policy == "fifo") {
+		schedulingPolicy = IArchMultithread::kSchedulingFIFO;
+		priority         = 10;
+	}
+	else {
+		return false;
+	}
+
+	// optional priority
+	if (colon != NULL) {
+		char* end;
+		priority = static_cast<int>(strtol(colon + 1, &end, 10));
+		if (end == colon + 1 || *end != '\0') {
+			return false;
+		}
+	}
+
+	m_setPolicy = true;
+	m_policy    = schedulingPolicy;
+	m_priority  = priority;
+	return true;
+}
+
+bool
+CThreadScheduling::parseCPUList(const char* arg)
+{
+	// comma separated list of CPU numbers and ranges of CPU numbers
+	std::vector<int> cpus;
+	const char* scan = arg;
+	for (;;) {
+		char* end;
+		long first = strtol(scan, &end, 10);
+		if (end == scan || first < 0) {
+			return false;
+		}
+		long last = first;
+		if (*end == '-') {
+			scan = end + 1;
+			last = strtol(scan, &end, 10);
+			if (end == scan || last < first) {
+				return false;
+			}
+		}
+		for (long cpu = first; cpu <= last; ++cpu) {
+			cpus.push_back(static_cast<int>(cpu));
+		}
+		if (*end == '\0') {
+			m_cpus.swap(cpus);
+			return true;
+		}
+		if (*end != ',') {
+			return false;
+		}
+		scan = end + 1;
+	}
+}
+
+void
+CThreadScheduling::setLockMemory(bool lockMemory)
+{
+	m_lockMemory = lockMemory;
+}
+
+void
+CThreadScheduling::apply() const
+{
+	// we run anyway if we can't change the scheduling
+	CArchThread thread = ARCH->newCurrentThread();
+	if (m_setPolicy &&
+		!ARCH->setSchedulingOfThread(thread, m_policy, m_priority)) {
+		LOG((CLOG_WARN "cannot change scheduling; check privileges"));
+	}
+	if (!m_cpus.empty() && !ARCH->setAffinityOfThread(thread, m_cpus)) {
+		LOG((CLOG_WARN "cannot change CPU affinity"));
+	}
+	ARCH->closeThread(thread);
+	if (m_lockMemory && !ARCH->lockMemory()) {
+		LOG((CLOG_WARN "cannot lock memory; check privileges"));
+	}
+}
@@ -0,0 +1,76 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2007 Chris Schoeneman
+ * 
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file COPYING that should have accompanied this file.
+ * 
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ */
+
+#ifndef CTHREADSCHEDULING_H
+#define CTHREADSCHEDULING_H
+
+#include "IArchMultithread.h"
+#include "stdvector.h"
+
+//! Input thread scheduling options
+/*!
+This class holds the scheduling options shared by the client and
+server programs (--scheduling, --cpu-affinity and --lock-memory) and
+applies them to the input handling threads.
+*/
+class CThreadScheduling {
+public:
+	CThreadScheduling();
+	~CThreadScheduling();
+
+	//! @name manipulators
+	//@{
+
+	//! Parse a scheduling policy
+	/*!
+	Parses \p arg of the form <policy>[:<priority>] where policy is
+	normal, rr or fifo.  For normal the priority is a nice value
+	(default -10), otherwise a real-time priority (default 10).
+	Returns false if \p arg is invalid.
+	*/
+	bool				parsePolicy(const char* arg);
+
+	//! Parse a CPU list
+	/*!
+	Parses \p arg, a comma separated list of CPU numbers and ranges of
+	CPU numbers (e.g. 0,2-3).  Returns false if \p arg is invalid.
+	*/
+	bool				parseCPUList(const char* arg);
+
+	//! Lock memory
+	/*!
+	Sets whether apply() locks the process's memory.
+	*/
+	void				setLockMemory(bool);
+
+	//! Apply the options
+	/*!
+	Applies the options to the calling thread and, for memory locking,
+	to the process.  Threads the calling thread creates later inherit
+	its scheduling.  Options that can't be applied, usually for lack of
+	privileges, are logged and otherwise ignored.
+	*/
+	void				apply() const;
+
+	//@}
+
+private:
+	bool				m_setPolicy;
+	IArchMultithread::ESchedulingPolicy	m_policy;
+	int					m_priority;
+	std::vector<int>	m_cpus;
+	bool				m_lockMemory;
+};
+
+#endif
@@ -49,7 +49,7 @@ IClipboard::unmarshall(IClipboard* clipboard, const CString& data, Time time)
 		// or server supports more clipboard formats than the other
 		// then one of them will get a format >= kNumFormats here.
 		if (format <IClipboard::kNumFormats) {
-			clipboard->add(format, CString(index, size));
+			clipboard->addShared(format, CSharedString(index, size));
 		}
 		index += size;
 	}
@@ -65,19 +65,23 @@ IClipboard::marshall(const IClipboard* clipboard)
 
 	CString data;
 
-	std::vector<CString> formatData;
+	std::vector<CSharedString> formatData;
 	formatData.resize(IClipboard::kNumFormats);
 	// FIXME -- use current time
 	clipboard->open(0);
 
-	// compute size of marshalled data
+	// compute size of marshalled data.  deferred formats have no data
+	// to send.
 	UInt32 size = 4;
 	UInt32 numFormats = 0;
+	bool added[IClipboard::kNumFormats];
 	for (UInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
-		if (clipboard->has(static_cast<IClipboard::EFormat>(format))) {
+		IClipboard::EFormat eFormat = static_cast<IClipboard::EFormat>(format);
+		added[format] = (clipboard->has(eFormat) &&
+						!clipboard->isDeferred(eFormat));
+		if (added[format]) {
 			++numFormats;
-			formatData[format] =
-				clipboard->get(static_cast<IClipboard::EFormat>(format));
+			formatData[format] = clipboard->getShared(eFormat);
 			size += 4 + 4 + formatData[format].size();
 		}
 	}
@@ -88,10 +92,10 @@ IClipboard::marshall(const IClipboard* clipboard)
 	// marshall the data
 	writeUInt32(&data, numFormats);
 	for (UInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
-		if (clipboard->has(static_cast<IClipboard::EFormat>(format))) {
+		if (added[format]) {
 			writeUInt32(&data, format);
 			writeUInt32(&data, formatData[format].size());
-			data += formatData[format];
+			data.append(formatData[format].data(), formatData[format].size());
 		}
 	}
 	clipboard->close();
@@ -99,6 +103,67 @@ IClipboard::marshall(const IClipboard* clipboard)
 	return data;
 }
 
+CSharedString::Hash
+IClipboard::hash(const IClipboard* clipboard)
+{
+	assert(clipboard != NULL);
+
+	CSharedString::Hash result = CSharedString::kHashInit;
+
+	// FIXME -- use current time
+	clipboard->open(0);
+	for (UInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		IClipboard::EFormat eFormat = static_cast<IClipboard::EFormat>(format);
+		if (clipboard->has(eFormat)) {
+			// mix in the format id and the format data's hash, serialized
+			// so the result doesn't depend on the host's byte order.
+			// deferred data is unknown so tag the format instead.
+			UInt8 buffer[12];
+			UInt32 tag = format;
+			CSharedString::Hash formatHash = 0;
+			if (clipboard->isDeferred(eFormat)) {
+				tag |= 0x80000000u;
+			}
+			else {
+				formatHash = clipboard->getShared(eFormat).getHash();
+			}
+			buffer[0] = static_cast<UInt8>((tag >> 24) & 0xff);
+			buffer[1] = static_cast<UInt8>((tag >> 16) & 0xff);
+			buffer[2] = static_cast<UInt8>((tag >>  8) & 0xff);
+			buffer[3] = static_cast<UInt8>( tag        & 0xff);
+			for (UInt32 i = 0; i < 8; ++i) {
+				buffer[4 + i] =
+					static_cast<UInt8>((formatHash >> (56 - 8 * i)) & 0xff);
+			}
+			result = CSharedString::hash(buffer, sizeof(buffer), result);
+		}
+	}
+	clipboard->close();
+
+	return result;
+}
+
+bool
+IClipboard::hasDeferred(const IClipboard* clipboard)
+{
+	assert(clipboard != NULL);
+
+	bool result = false;
+
+	// FIXME -- use current time
+	clipboard->open(0);
+	for (UInt32 format = 0; format != IClipboard::kNumFormats; ++format) {
+		IClipboard::EFormat eFormat = static_cast<IClipboard::EFormat>(format);
+		if (clipboard->has(eFormat) && clipboard->isDeferred(eFormat)) {
+			result = true;
+			break;
+		}
+	}
+	clipboard->close();
+
+	return result;
+}
+
 bool
 IClipboard::copy(IClipboard* dst, const IClipboard* src)
 {
@@ -121,8 +186,14 @@ IClipboard::copy(IClipboard* dst, const IClipboard* src, Time time)
 				for (SInt32 format = 0;
 								format != IClipboard::kNumFormats; ++format) {
 					IClipboard::EFormat eFormat = (IClipboard::EFormat)format;
-					if (src->has(eFormat)) {
-						dst->add(eFormat, src->get(eFormat));
+					if (!src->has(eFormat)) {
+						continue;
+					}
+					if (src->isDeferred(eFormat)) {
+						dst->addDeferred(eFormat);
+					}
+					else {
+						dst->addShared(eFormat, src->getShared(eFormat));
 					}
 				}
 				success = true;
@@ -17,6 +17,7 @@
 
 #include "IInterface.h"
 #include "CString.h"
+#include "CSharedString.h"
 #include "BasicTypes.h"
 
 //! Clipboard interface
@@ -78,6 +79,26 @@ public:
 	*/
 	virtual void		add(EFormat, const CString& data) = 0;
 
+	//! Add shared data
+	/*!
+	Same as add() except the data is refcounted.  Clipboards that
+	store their data in memory should keep a reference to \p data
+	rather than copying it.
+	*/
+	virtual void		addShared(EFormat, const CSharedString& data) = 0;
+
+	//! Add deferred data
+	/*!
+	Add the given format to the clipboard without its data.  This is
+	for data that's expensive to get, such as data on another
+	computer, and that may never be needed.  has() returns true for
+	the format and get() returns the empty string.  The data is
+	expected later in a clipboard with the same formats.  Clipboards
+	that can't wait for data should ignore the format.  May only be
+	called after a successful empty().
+	*/
+	virtual void		addDeferred(EFormat) = 0;
+
 	//@}
 	//! @name accessors
 	//@{
@@ -124,10 +145,28 @@ public:
 	*/
 	virtual CString		get(EFormat) const = 0;
 
+	//! Get shared data
+	/*!
+	Same as get() except the data is refcounted.  Clipboards that
+	store their data in memory should return a reference to it rather
+	than a copy.  Must be called between a successful open() and
+	close().
+	*/
+	virtual CSharedString	getShared(EFormat) const = 0;
+
+	//! Check for deferred data
+	/*!
+	Return true iff the clipboard has the given format but its data
+	was deferred by addDeferred().  Must be called between a
+	successful open() and close().
+	*/
+	virtual bool		isDeferred(EFormat) const = 0;
+
 	//! Marshall clipboard data
 	/*!
 	Merge \p clipboard's data into a single buffer that can be later
 	unmarshalled to restore the clipboard and return the buffer.
+	Deferred formats are not included.
 	*/
 	static CString		marshall(const IClipboard* clipboard);
 
@@ -139,13 +178,32 @@ public:
 	static void			unmarshall(IClipboard* clipboard,
 							const CString& data, Time time);
 
+	//! Hash clipboard data
+	/*!
+	Return a hash of \p clipboard's formats and data.  Two clipboards
+	have the same hash if they have the same data in the same formats.
+	The hash of each format comes from CSharedString::getHash() so
+	it's cheap to compute for clipboards that cache it.  Deferred
+	formats contribute only the format, so clipboards with deferred
+	data may have the same hash even if their data differs.
+	*/
+	static CSharedString::Hash
+						hash(const IClipboard* clipboard);
+
+	//! Check for deferred data
+	/*!
+	Return true iff any format in \p clipboard is deferred.
+	*/
+	static bool			hasDeferred(const IClipboard* clipboard);
+
 	//! Copy clipboard
 	/*!
 	Transfers all the data in one clipboard to another.  The
 	clipboards can be of any concrete clipboard type (and
-	they don't have to be the same type).  This also sets
-	the destination clipboard's timestamp to source clipboard's
-	timestamp.  Returns true iff the copy succeeded.
+	they don't have to be the same type).  Deferred formats
+	stay deferred.  This also sets the destination clipboard's
+	timestamp to source clipboard's timestamp.  Returns true iff
+	the copy succeeded.
 	*/
 	static bool			copy(IClipboard* dst, const IClipboard* src);
 
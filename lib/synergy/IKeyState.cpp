@@ -13,6 +13,7 @@
  */
 
 #include "IKeyState.h"
+#include "CArch.h"
 #include <string.h>
 
 //
@@ -58,6 +59,7 @@ IKeyState::CKeyInfo::alloc(KeyID id,
 	info->m_mask             = mask;
 	info->m_button           = button;
 	info->m_count            = count;
+	info->m_time             = ARCH->time();
 	info->m_screens          = NULL;
 	info->m_screensBuffer[0] = '\0';
 	return info;
@@ -76,6 +78,7 @@ IKeyState::CKeyInfo::alloc(KeyID id,
 	info->m_mask    = mask;
 	info->m_button  = button;
 	info->m_count   = count;
+	info->m_time    = ARCH->time();
 	info->m_screens = info->m_screensBuffer;
 	strcpy(info->m_screensBuffer, screens.c_str());
 	return info;
@@ -90,6 +93,7 @@ IKeyState::CKeyInfo::alloc(const CKeyInfo& x)
 	info->m_mask    = x.m_mask;
 	info->m_button  = x.m_button;
 	info->m_count   = x.m_count;
+	info->m_time    = x.m_time;
 	info->m_screens = x.m_screens ? info->m_screensBuffer : NULL;
 	strcpy(info->m_screensBuffer, x.m_screensBuffer);
 	return info;
@@ -33,6 +33,10 @@ public:
 	};
 
 	//! Key event data
+	/*!
+	\c m_time is the ARCH->time() when the key event was captured,
+	for measuring input latency.  Copies keep the original time.
+	*/
 	class CKeyInfo {
 	public:
 		static CKeyInfo* alloc(KeyID, KeyModifierMask, KeyButton, SInt32 count);
@@ -51,6 +55,7 @@ public:
 		KeyModifierMask	m_mask;
 		KeyButton		m_button;
 		SInt32			m_count;
+		double			m_time;
 		char*			m_screens;
 		char			m_screensBuffer[1];
 	};
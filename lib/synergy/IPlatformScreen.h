@@ -134,6 +134,15 @@ public:
 	*/
 	virtual bool		isPrimary() const = 0;
 
+	//! Get some clipboard formats
+	/*!
+	Like getClipboard() except only formats whose bit (1 << format) is
+	set in \c formats need be converted.  Screens that can may add the
+	other available formats as deferred.
+	*/
+	virtual bool		getClipboardFormats(ClipboardID, IClipboard*,
+							UInt32 formats) const = 0;
+
 	//@}
 
 	// IScreen overrides
@@ -13,6 +13,7 @@
  */
 
 #include "IPrimaryScreen.h"
+#include "CArch.h"
 
 //
 // IPrimaryScreen
@@ -145,8 +146,9 @@ IPrimaryScreen::CMotionInfo*
 IPrimaryScreen::CMotionInfo::alloc(SInt32 x, SInt32 y)
 {
 	CMotionInfo* info = (CMotionInfo*)malloc(sizeof(CMotionInfo));
-	info->m_x = x;
-	info->m_y = y;
+	info->m_x    = x;
+	info->m_y    = y;
+	info->m_time = ARCH->time();
 	return info;
 }
 
@@ -40,6 +40,10 @@ public:
 		KeyModifierMask	m_mask;
 	};
 	//! Motion event data
+	/*!
+	\c m_time is the ARCH->time() when the motion was captured, for
+	measuring input latency.
+	*/
 	class CMotionInfo {
 	public:
 		static CMotionInfo* alloc(SInt32 x, SInt32 y);
@@ -47,6 +51,7 @@ public:
 	public:
 		SInt32			m_x;
 		SInt32			m_y;
+		double			m_time;
 	};
 	//! Wheel motion event data
 	class CWheelInfo {
@@ -18,11 +18,12 @@
 // IScreen
 //
 
-CEvent::Type			IScreen::s_errorEvent            = CEvent::kUnknown;
-CEvent::Type			IScreen::s_shapeChangedEvent     = CEvent::kUnknown;
-CEvent::Type			IScreen::s_clipboardGrabbedEvent = CEvent::kUnknown;
-CEvent::Type			IScreen::s_suspendEvent          = CEvent::kUnknown;
-CEvent::Type			IScreen::s_resumeEvent           = CEvent::kUnknown;
+CEvent::Type			IScreen::s_errorEvent              = CEvent::kUnknown;
+CEvent::Type			IScreen::s_shapeChangedEvent       = CEvent::kUnknown;
+CEvent::Type			IScreen::s_clipboardGrabbedEvent   = CEvent::kUnknown;
+CEvent::Type			IScreen::s_clipboardRequestedEvent = CEvent::kUnknown;
+CEvent::Type			IScreen::s_suspendEvent            = CEvent::kUnknown;
+CEvent::Type			IScreen::s_resumeEvent             = CEvent::kUnknown;
 
 CEvent::Type
 IScreen::getErrorEvent()
@@ -45,6 +46,13 @@ IScreen::getClipboardGrabbedEvent()
 							"IScreen::clipboardGrabbed");
 }
 
+CEvent::Type
+IScreen::getClipboardRequestedEvent()
+{
+	return CEvent::registerTypeOnce(s_clipboardRequestedEvent,
+							"IScreen::clipboardRequested");
+}
+
 CEvent::Type
 IScreen::getSuspendEvent()
 {
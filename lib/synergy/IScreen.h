@@ -85,6 +85,16 @@ public:
 	*/
 	static CEvent::Type	getClipboardGrabbedEvent();
 
+	//! Get clipboard requested event type
+	/*!
+	Returns the clipboard requested event type.  This is sent when the
+	screen needs clipboard data that was deferred (see
+	IClipboard::addDeferred()), typically because an application is
+	pasting it.  The data should be supplied by setting the clipboard
+	again.  The data is a pointer to a CClipboardInfo.
+	*/
+	static CEvent::Type	getClipboardRequestedEvent();
+
 	//! Get suspend event type
 	/*!
 	Returns the suspend event type. This is sent whenever the system goes
@@ -105,6 +115,7 @@ private:
 	static CEvent::Type	s_errorEvent;
 	static CEvent::Type	s_shapeChangedEvent;
 	static CEvent::Type	s_clipboardGrabbedEvent;
+	static CEvent::Type	s_clipboardRequestedEvent;
 	static CEvent::Type	s_suspendEvent;
 	static CEvent::Type	s_resumeEvent;
 };
@@ -38,9 +38,12 @@ const char*				kMsgDMouseRelMove	= "DMRM%2i%2i";
 const char*				kMsgDMouseWheel		= "DMWM%2i%2i";
 const char*				kMsgDMouseWheel1_0	= "DMWM%2i";
 const char*				kMsgDClipboard		= "DCLP%1i%4i%s";
+const char*				kMsgDClipboardOffer	= "DCLO%1i%4i%s";
+const char*				kMsgDClipboardFormats	= "DCLF%1i%1i%4i%s";
 const char*				kMsgDInfo			= "DINF%2i%2i%2i%2i%2i%2i%2i";
 const char*				kMsgDSetOptions		= "DSOP%4I";
 const char*				kMsgQInfo			= "QINF";
+const char*				kMsgQClipboard		= "QCLP%1i%1I";
 const char*				kMsgEIncompatible	= "EICV%2i%2i";
 const char*				kMsgEBusy 			= "EBSY";
 const char*				kMsgEUnknown		= "EUNK";
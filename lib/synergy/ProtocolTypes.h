@@ -23,8 +23,14 @@
 // 1.2:  adds mouse relative motion
 // 1.3:  adds keep alive and deprecates heartbeats,
 //       adds horizontal mouse scrolling
+// 1.4:  adds clipboard offers to avoid resending cached clipboard data
 static const SInt16		kProtocolMajorVersion = 1;
-static const SInt16		kProtocolMinorVersion = 3;
+static const SInt16		kProtocolMinorVersion = 4;
+
+// oldest protocol minor version of the server a client will talk to.
+// clients reply to the server's hello with the lesser of the server's
+// and their own version.
+static const SInt16		kProtocolMinimumMinorVersion = 3;
 
 // default contact port number
 static const UInt16		kDefaultPort = 24800;
@@ -40,6 +46,22 @@ static const double		kKeepAliveRate = 3.0;
 // number of skipped kMsgCKeepAlive messages that indicates a problem
 static const double		kKeepAlivesUntilDeath = 3.0;
 
+// maximum number of clipboard formats and total bytes of clipboard data
+// each side of a connection remembers for kMsgDClipboardOffer.  the
+// sides don't have to agree on these.
+static const UInt32		kClipboardCacheEntries = 32;
+static const UInt32		kClipboardCacheSize = 64 * 1024 * 1024;
+
+// maximum size of each chunk of a kMsgDClipboardFormats reply and the
+// largest total reply a receiver will accept.
+static const UInt32		kClipboardChunkSize = 32 * 1024;
+static const UInt32		kClipboardTransferMaxSize = 256 * 1024 * 1024;
+
+// size of a format in kMsgDClipboardOffer whose data the sender hasn't
+// converted yet.  it's larger than kClipboardTransferMaxSize so it can't
+// be a real size.
+static const UInt32		kClipboardUnknownSize = 0xffffffffu;
+
 // obsolete heartbeat stuff
 static const double		kHeartRate = -1.0;
 static const double		kHeartBeatsUntilDeath = 3.0;
@@ -63,6 +85,18 @@ enum EDirectionMask {
 	kBottomMask = 1 << kBottom
 };
 
+// kMsgDClipboardFormats chunk types.  a kClipboardChunkStart begins a
+// new reply, discarding any partial reply for the clipboard.  a
+// kClipboardChunkCancel discards the partial reply and tells the
+// receiver no data is coming for its query;  the sender sends it when
+// the clipboard changes before the reply is complete or when it can't
+// convert the requested formats.
+enum EClipboardChunk {
+	kClipboardChunkStart,
+	kClipboardChunkData,
+	kClipboardChunkCancel
+};
+
 
 //
 // message codes (trailing NUL is not part of code).  in comments, $n
@@ -219,6 +253,37 @@ extern const char*		kMsgDMouseWheel1_0;
 // identifier.
 extern const char*		kMsgDClipboard;
 
+// clipboard offer:  primary <-> secondary
+// sent instead of kMsgDClipboard when both sides support protocol 1.4.
+// $1 = clipboard identifier, $2 = sequence number as in kMsgDClipboard.
+// $3 = the list of formats in the clipboard without their data:  a 4
+// byte count of formats followed by, for each format, the 4 byte
+// format identifier, the 4 byte size of the data and the 8 byte hash
+// of the data (see CSharedString::hash()), all in NBO.  the receiver
+// takes the data for each format from its cache of recently sent and
+// received clipboard data.  the clipboard changes immediately but the
+// receiver doesn't request the formats it doesn't have using
+// kMsgQClipboard until something needs the data, usually a paste.
+// the sender must keep the data until the next offer.  a format with
+// size kClipboardUnknownSize (and hash 0) is available but not yet
+// converted by the sender;  it's never in the cache and any data the
+// sender replies with for it is accepted.
+extern const char*		kMsgDClipboardOffer;
+
+// clipboard formats:  primary <-> secondary
+// sent in response to kMsgQClipboard.  the reply is clipboard data
+// holding only the requested formats, marshalled as in kMsgDClipboard,
+// and is split into chunks of at most kClipboardChunkSize bytes so
+// other messages can be sent between them.  $1 = clipboard identifier,
+// $2 = EClipboardChunk, $3 = total size of the data for
+// kClipboardChunkStart and 0 otherwise, $4 = chunk data.  the reply
+// is complete once $3 bytes have arrived.  the data is for the most
+// recent offer sent for the clipboard;  receivers must ignore formats
+// whose hash doesn't match the offer they're waiting on.  requested
+// formats missing from a complete reply, or all of them if the reply
+// is cancelled, are unavailable.
+extern const char*		kMsgDClipboardFormats;
+
 // client data:  secondary -> primary
 // $1 = coordinate of leftmost pixel on secondary screen,
 // $2 = coordinate of topmost pixel on secondary screen,
@@ -249,6 +314,13 @@ extern const char*		kMsgDSetOptions;
 // client should reply with a kMsgDInfo.
 extern const char*		kMsgQInfo;
 
+// query clipboard formats:  primary <-> secondary
+// sent after a kMsgDClipboardOffer for formats not in the receiver's
+// cache, once the receiver needs them.  the sender should reply with
+// kMsgDClipboardFormats.
+// $1 = clipboard identifier, $2 = list of 1 byte format identifiers.
+extern const char*		kMsgQClipboard;
+
 
 //
 // error codes